@@ -0,0 +1,4 @@
+// Tweaks for the build that tests the opt-in statistics. Use with `--tweaks-dir=conf/stats`.
+#define Neo_ToggleFeature_TerseLambdaMSVCNoexceptWorkaround Enabled
+#define Neo_ToggleFeature_CoroFrameStats Enabled
+#define Neo_ToggleFeature_EventStats Enabled
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "./addressof.hpp"
+#include "./concepts.hpp"
+#include "./frame_alloc.hpp"
+#include "./fwd.hpp"
+#include "./type_traits.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+
+namespace neo {
+
+/**
+ * @brief A coroutine type that asynchronously yields a sequence of values.
+ *
+ * Unlike `generator<T>`, the body of an async_generator may `co_await` any awaitable
+ * between yields, and advancing the generator is itself an awaitable operation:
+ *
+ * ```
+ * for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it) {
+ *     use(*it);
+ * }
+ * ```
+ *
+ * When the generator produces a value, the consumer is resumed via symmetric transfer
+ * on whichever thread the generator happens to be running on at the time.
+ *
+ * The coroutine frame is allocated using `frame_alloc_promise_base`, so an async_generator
+ * may accept a leading `std::allocator_arg_t, Alloc` pair of parameters.
+ *
+ * @tparam T The type of objects that will be generated
+ */
+template <typename T>
+class [[nodiscard]] async_generator {
+public:
+    using yield_type = T;
+
+    class promise_type : public frame_alloc_promise_base_for<"neo::async_generator"> {
+    public:
+        using reference_type = yield_type&;
+        using pointer_type   = add_pointer_t<reference_type>;
+        using value_type     = remove_cvref_t<yield_type>;
+
+    private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        std::exception_ptr _exc     = nullptr;
+        pointer_type       _current = nullptr;
+        /// The coroutine that is waiting for us to produce the next value
+        std::coroutine_handle<> _consumer = std::noop_coroutine();
+
+        friend async_generator;
+
+        using lref  = value_type&;
+        using rref  = value_type&&;
+        using clref = value_type const&;
+
+        // Used when a value is yielded and at the end of the generator, to resume the consumer
+        struct yield_awaiter {
+            constexpr bool          await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle_type co) const noexcept {
+                return co.promise()._consumer;
+            }
+            constexpr void await_resume() const noexcept {}
+        };
+
+    public:
+        async_generator get_return_object() noexcept {
+            return async_generator{handle_type::from_promise(*this)};
+        }
+
+        constexpr auto initial_suspend() const noexcept { return std::suspend_always{}; }
+        constexpr auto final_suspend() const noexcept { return yield_awaiter{}; }
+
+        constexpr auto yield_value(lref v) noexcept
+            requires constructible_from<T, lref>
+        {
+            _current = NEO_ADDRESSOF(v);
+            return yield_awaiter{};
+        }
+
+        constexpr auto yield_value(clref v) noexcept
+            requires constructible_from<T, clref> and convertible_to<const value_type*, pointer_type>
+        {
+            _current = NEO_ADDRESSOF(v);
+            return yield_awaiter{};
+        }
+
+        /**
+         * @brief Yield a copy of a const object. Used if the yield type is not a
+         * reference-to-const, since the consumer may modify or move from the yielded object.
+         */
+        constexpr auto yield_value(clref v) noexcept(nothrow_constructible_from<value_type, clref>)
+            requires constructible_from<T, clref>
+            and (not convertible_to<const value_type*, pointer_type>)
+        {
+            struct copy_awaiter : yield_awaiter {
+                promise_type& self;
+                value_type    copy;
+
+                std::coroutine_handle<> await_suspend(handle_type co) noexcept {
+                    self._current = NEO_ADDRESSOF(copy);
+                    return yield_awaiter::await_suspend(co);
+                }
+            };
+            return copy_awaiter{{}, *this, value_type(v)};
+        }
+
+        constexpr auto yield_value(rref v) noexcept
+            requires constructible_from<T, rref>
+        {
+            _current = NEO_ADDRESSOF(v);
+            return yield_awaiter{};
+        }
+
+        // The exception will be rethrown from the `co_await` that is advancing the generator
+        constexpr void unhandled_exception() noexcept { _exc = std::current_exception(); }
+
+        constexpr void return_void() noexcept {}
+
+        constexpr reference_type get_value() const noexcept { return *_current; }
+
+        void throw_if_exc() const {
+            if (_exc) {
+                std::rethrow_exception(_exc);
+            }
+        }
+    };
+
+    class iterator;
+
+private:
+    using handle_type = std::coroutine_handle<promise_type>;
+    handle_type _coro = nullptr;
+
+    constexpr explicit async_generator(handle_type h) noexcept
+        : _coro(h) {}
+
+    /**
+     * @brief Awaiter that resumes the generator until it yields its next value or completes.
+     *
+     * @tparam Result The type of the `co_await` expression. Either an iterator or a reference
+     * to the iterator that is being incremented.
+     */
+    template <typename Result>
+    struct advance_awaiter {
+        handle_type _coro;
+        Result      _result;
+
+        bool await_ready() const noexcept { return not _coro or _coro.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) const noexcept {
+            _coro.promise()._consumer = consumer;
+            return _coro;
+        }
+
+        Result await_resume() const {
+            if (_coro and _coro.done()) {
+                _coro.promise().throw_if_exc();
+            }
+            return _result;
+        }
+    };
+
+public:
+    class iterator {
+        handle_type _coro = nullptr;
+
+        friend async_generator;
+        constexpr explicit iterator(handle_type h) noexcept
+            : _coro(h) {}
+
+    public:
+        constexpr iterator() = default;
+
+        using iterator_category = std::input_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = remove_cvref_t<yield_type>;
+        using reference         = T&&;
+        using pointer           = typename promise_type::pointer_type;
+
+        struct sentinel_type {};
+
+        [[nodiscard]] constexpr bool operator==(sentinel_type) const noexcept {
+            return not _coro or _coro.done();
+        }
+
+        [[nodiscard]] constexpr reference operator*() const noexcept {
+            return static_cast<reference>(_coro.promise().get_value());
+        }
+
+        /**
+         * @brief Resume the generator to produce its next value.
+         *
+         * @return An awaitable that completes with a reference to this iterator once the next
+         * value is available, or once the generator has finished.
+         */
+        [[nodiscard]] advance_awaiter<iterator&> operator++() noexcept { return {_coro, *this}; }
+    };
+
+    constexpr async_generator() noexcept = default;
+
+    constexpr async_generator(async_generator&& other) noexcept
+        : _coro(other._coro) {
+        other._coro = nullptr;
+    }
+
+    ~async_generator() {
+        if (_coro) {
+            _coro.destroy();
+        }
+    }
+
+    constexpr async_generator& operator=(async_generator&& other) noexcept {
+        if (_coro) {
+            _coro.destroy();
+        }
+        _coro       = other._coro;
+        other._coro = nullptr;
+        return *this;
+    }
+
+    /**
+     * @brief Start the generator and wait for the first value.
+     *
+     * @return An awaitable that completes with a new iterator once the first value is
+     * available, or once the generator has finished.
+     */
+    [[nodiscard]] advance_awaiter<iterator> begin() noexcept {
+        return {_coro, iterator{_coro}};
+    }
+
+    /// Obtain a sentinel indicating completion of the generator
+    [[nodiscard]] constexpr auto end() const noexcept { return typename iterator::sentinel_type{}; }
+};
+
+}  // namespace neo
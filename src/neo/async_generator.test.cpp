@@ -0,0 +1,141 @@
+#include "./async_generator.hpp"
+
+#include "./sync_wait.hpp"
+#include "./task.hpp"
+#include "./thread_pool_scheduler.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+neo::task<int> fetch_page_size(int page) { co_return page + 1; }
+
+/// Yields the numbers of each page, waiting for the page to "load" before each yield
+neo::async_generator<int> paged(int n_pages) {
+    for (int page = 0; page < n_pages; ++page) {
+        auto size = co_await fetch_page_size(page);
+        for (int i = 0; i < size; ++i) {
+            co_yield page;
+        }
+    }
+}
+
+template <typename T>
+neo::task<std::vector<T>> collect(neo::async_generator<T> gen) {
+    std::vector<T> ret;
+    auto           it = co_await gen.begin();
+    while (it != gen.end()) {
+        ret.push_back(*it);
+        co_await ++it;
+    }
+    co_return ret;
+}
+
+}  // namespace
+
+TEST_CASE("Iterate an async generator") {
+    auto got = neo::sync_wait(collect(paged(4)));
+    CHECK(got == std::vector<int>{0, 1, 1, 2, 2, 2, 3, 3, 3, 3});
+}
+
+TEST_CASE("Iterate an async generator with a for-loop") {
+    auto gen = paged(3);
+    auto sum = neo::sync_wait([&]() -> neo::task<int> {
+        int sum = 0;
+        for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it) {
+            sum += *it;
+        }
+        co_return sum;
+    }());
+    CHECK(sum == 0 + 1 + 1 + 2 + 2 + 2);
+}
+
+TEST_CASE("Empty async generator") {
+    auto got = neo::sync_wait(collect(paged(0)));
+    CHECK(got.empty());
+}
+
+TEST_CASE("Async generators are lazy") {
+    bool started = false;
+    auto fn      = [&]() -> neo::async_generator<int> {
+        started = true;
+        co_yield 1;
+    };
+    auto gen = fn();
+    CHECK_FALSE(started);
+    auto got = neo::sync_wait(collect(std::move(gen)));
+    CHECK(started);
+    CHECK(got == std::vector<int>{1});
+}
+
+TEST_CASE("Yield references from an async generator") {
+    std::string s   = "hello";
+    auto        gen = [](std::string& s) -> neo::async_generator<std::string&> { co_yield s; }(s);
+    neo::sync_wait([&]() -> neo::task<> {
+        auto it = co_await gen.begin();
+        CHECK(it != gen.end());
+        (*it).append(", world");
+        co_await ++it;
+        CHECK(it == gen.end());
+    }());
+    CHECK(s == "hello, world");
+}
+
+TEST_CASE("Yield move-only objects from an async generator") {
+    auto gen = []() -> neo::async_generator<std::unique_ptr<int>> {
+        co_yield std::make_unique<int>(1729);
+    }();
+    auto got = neo::sync_wait(collect(std::move(gen)));
+    REQUIRE(got.size() == 1);
+    CHECK(*got[0] == 1729);
+}
+
+TEST_CASE("Exceptions propagate from an async generator") {
+    auto gen = []() -> neo::async_generator<int> {
+        co_yield 1;
+        co_await fetch_page_size(0);
+        throw std::runtime_error("oops");
+    }();
+    neo::sync_wait([&]() -> neo::task<> {
+        auto it = co_await gen.begin();
+        CHECK(*it == 1);
+        CHECK_THROWS_AS(co_await ++it, std::runtime_error);
+        CHECK(it == gen.end());
+    }());
+}
+
+TEST_CASE("Stop consuming an async generator early") {
+    auto gen = paged(1000);
+    auto got = neo::sync_wait([&]() -> neo::task<int> {
+        auto it = co_await gen.begin();
+        co_await ++it;
+        co_await ++it;
+        co_return *it;
+    }());
+    CHECK(got == 1);
+    // The generator is destroyed while suspended
+}
+
+TEST_CASE("Async generator that hops onto a thread pool") {
+    neo::thread_pool_scheduler pool{2};
+    const auto                 main_id = std::this_thread::get_id();
+
+    auto gen = [](neo::thread_pool_scheduler& pool) -> neo::async_generator<std::thread::id> {
+        for (int i = 0; i < 100; ++i) {
+            co_await pool.schedule();
+            co_yield std::this_thread::get_id();
+        }
+    }(pool);
+
+    auto ids = neo::sync_wait(collect(std::move(gen)));
+    REQUIRE(ids.size() == 100);
+    for (auto id : ids) {
+        CHECK(id != main_id);
+    }
+}
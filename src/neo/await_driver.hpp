@@ -0,0 +1,122 @@
+#pragma once
+
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./type_traits.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace neo {
+
+/**
+ * @brief The coroutine that the blocking and joining operations (`sync_wait()`, `when_all()`,
+ * and the `run()` of the I/O contexts) use to await an arbitrary awaitable and keep its result.
+ */
+namespace await_driver_detail {
+
+/// Implements the return value aspect of a driver
+template <typename T>
+struct return_part {
+    optional<T> _value;
+
+    template <typename U>
+    void return_value(U&& u) {
+        _value.emplace(NEO_FWD(u));
+    }
+
+    T take() { return static_cast<add_rvalue_reference_t<T>>(*_value); }
+};
+
+template <void_type T>
+struct return_part<T> {
+    void return_void() noexcept {}
+    void take() noexcept {}
+};
+
+/// Completion of a driver that does nothing. The owner checks `driver::done()` instead.
+struct stay_suspended {
+    std::coroutine_handle<> operator()() const noexcept { return std::noop_coroutine(); }
+};
+
+/**
+ * @brief A coroutine that awaits a single awaitable and stores its result or its exception.
+ *
+ * The driver starts suspended. When it finishes, it stays suspended at its final suspend
+ * point, and invokes its `Completion`, which returns the coroutine to resume next.
+ *
+ * @tparam T The result type of the awaitable
+ * @tparam Completion An invocable that is called when the driver finishes
+ */
+template <typename T, typename Completion = stay_suspended>
+struct driver {
+    struct promise_type : return_part<T> {
+        Completion         completion{};
+        std::exception_ptr exception;
+
+        driver get_return_object() noexcept {
+            return driver{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        auto final_suspend() const noexcept {
+            struct awaiter {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> co) const noexcept {
+                    return co.promise().completion();
+                }
+                void await_resume() const noexcept {}
+            };
+            return awaiter{};
+        }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    std::coroutine_handle<promise_type> co;
+
+    explicit driver(std::coroutine_handle<promise_type> h) noexcept
+        : co(h) {}
+
+    driver(driver&& o) noexcept
+        : co(std::exchange(o.co, nullptr)) {}
+
+    ~driver() {
+        if (co) {
+            co.destroy();
+        }
+    }
+
+    Completion& completion() noexcept { return co.promise().completion; }
+    void        start() { co.resume(); }
+    bool        done() const noexcept { return co.done(); }
+
+    /// Rethrow the exception of the awaitable, if it threw one
+    void rethrow_if_failed() const {
+        if (co.promise().exception) {
+            std::rethrow_exception(co.promise().exception);
+        }
+    }
+
+    /// Obtain the result of the awaitable, or rethrow its exception
+    T take() {
+        rethrow_if_failed();
+        return co.promise().take();
+    }
+};
+
+template <typename T, typename Completion = stay_suspended, typename Awaitable>
+driver<T, Completion> make_driver(Awaitable&& a) {
+    if constexpr (void_type<T>) {
+        co_await NEO_FWD(a);
+    } else {
+        co_return co_await NEO_FWD(a);
+    }
+}
+
+}  // namespace await_driver_detail
+
+}  // namespace neo
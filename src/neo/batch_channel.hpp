@@ -0,0 +1,235 @@
+#pragma once
+
+#include "./addressof.hpp"
+#include "./concepts.hpp"
+#include "./frame_alloc.hpp"
+#include "./fwd.hpp"
+#include "./type_traits.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace neo {
+
+/**
+ * @brief A producer coroutine that yields values into a fixed-capacity buffer, and only
+ * suspends once the buffer is full.
+ *
+ * With `channel<T>`, every `co_yield` suspends the coroutine and every value taken from the
+ * pipe resumes it. For small values the cost of switching coroutines can dominate the
+ * actual work. A batch_channel instead constructs each yielded value in a buffer in its
+ * coroutine frame, and a `co_yield` only suspends when the buffer is full or when the
+ * coroutine finishes. The consumer then walks the whole buffer before resuming the
+ * coroutine again.
+ *
+ * Values may be consumed one at a time using `begin()`/`end()`, or a batch at a time using
+ * `next_batch()`. Do not mix the two on the same batch_channel.
+ *
+ * The coroutine frame is allocated using `frame_alloc_promise_base`, so a batch_channel
+ * coroutine may accept a leading `std::allocator_arg_t, Alloc` pair of parameters.
+ *
+ * @tparam T The type of values that are yielded. Must be an object type.
+ * @tparam BatchSize The capacity of the buffer.
+ */
+template <typename T, std::size_t BatchSize = 64>
+class [[nodiscard]] batch_channel {
+    static_assert(not reference_type<T> and not void_type<T>,
+                  "batch_channel<T> requires an object type, since values are stored in a buffer");
+    static_assert(BatchSize > 0, "batch_channel<T> requires a non-zero BatchSize");
+
+public:
+    using yield_type = T;
+
+    class promise_type : public frame_alloc_promise_base_for<"neo::batch_channel"> {
+        // The buffer of yielded values. The first `_size` elements are alive.
+        union {
+            T _items[BatchSize];
+        };
+        std::size_t        _size = 0;
+        std::exception_ptr _exc  = nullptr;
+
+        friend batch_channel;
+
+        struct yield_awaiter {
+            const promise_type& self;
+
+            // Only suspend once the buffer is full
+            constexpr bool await_ready() const noexcept { return self._size < BatchSize; }
+            constexpr void await_suspend(std::coroutine_handle<>) const noexcept {}
+            constexpr void await_resume() const noexcept {}
+        };
+
+        void _clear() noexcept {
+            std::destroy_n(_items, _size);
+            _size = 0;
+        }
+
+        void _throw_if_exc() {
+            if (_exc) {
+                std::rethrow_exception(std::exchange(_exc, nullptr));
+            }
+        }
+
+    public:
+        promise_type() noexcept {}
+        ~promise_type() { _clear(); }
+
+        batch_channel get_return_object() noexcept {
+            return batch_channel{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        constexpr auto initial_suspend() const noexcept { return std::suspend_always{}; }
+        constexpr auto final_suspend() const noexcept { return std::suspend_always{}; }
+
+        yield_awaiter yield_value(T&& v) noexcept(nothrow_constructible_from<T, T&&>) {
+            std::construct_at(NEO_ADDRESSOF(_items[_size]), NEO_MOVE(v));
+            ++_size;
+            return yield_awaiter{*this};
+        }
+
+        yield_awaiter yield_value(const T& v) noexcept(nothrow_constructible_from<T, const T&>) {
+            std::construct_at(NEO_ADDRESSOF(_items[_size]), v);
+            ++_size;
+            return yield_awaiter{*this};
+        }
+
+        // The exception is rethrown after the consumer has seen every value that was yielded
+        // before it was thrown.
+        void unhandled_exception() noexcept { _exc = std::current_exception(); }
+
+        constexpr void return_void() noexcept {}
+
+        // Disable 'co_await' inside of a batch_channel
+        template <typename Other>
+        [[deprecated("You cannot use 'co_await' inside a batch_channel")]]  //
+        std::suspend_never
+        await_transform(Other&&)
+            = delete;
+    };
+
+private:
+    using handle_type = std::coroutine_handle<promise_type>;
+    handle_type _coro = nullptr;
+
+    constexpr explicit batch_channel(handle_type h) noexcept
+        : _coro(h) {}
+
+    // Discard the current batch and run the coroutine until it has produced the next one.
+    static void _refill(handle_type co) {
+        auto& pr = co.promise();
+        pr._clear();
+        if (not co.done()) {
+            co.resume();
+        }
+        if (pr._size == 0) {
+            pr._throw_if_exc();
+        }
+    }
+
+public:
+    class iterator {
+        handle_type _coro = nullptr;
+        // The current value, and the end of the current batch
+        T* _cur  = nullptr;
+        T* _stop = nullptr;
+
+        friend batch_channel;
+        explicit iterator(handle_type h) noexcept
+            : _coro(h) {
+            _reset();
+        }
+
+        void _reset() noexcept {
+            auto& pr = _coro.promise();
+            _cur     = pr._items;
+            _stop    = _cur + pr._size;
+        }
+
+    public:
+        constexpr iterator() = default;
+
+        using iterator_category = std::input_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = T;
+        using reference         = T&;
+
+        [[nodiscard]] constexpr bool operator==(std::default_sentinel_t) const noexcept {
+            return _cur == _stop and _coro.done();
+        }
+
+        /// Obtain the current value. The consumer may move from the referred-to object.
+        [[nodiscard]] constexpr reference operator*() const noexcept { return *_cur; }
+
+        /**
+         * @brief Advance to the next value. Only resumes the coroutine once every value in the
+         * current batch has been visited.
+         */
+        iterator& operator++() {
+            if (++_cur == _stop) {
+                _refill(_coro);
+                _reset();
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+    };
+
+    constexpr batch_channel() noexcept = default;
+
+    constexpr batch_channel(batch_channel&& other) noexcept
+        : _coro(std::exchange(other._coro, nullptr)) {}
+
+    constexpr batch_channel& operator=(batch_channel&& other) noexcept {
+        if (_coro) {
+            _coro.destroy();
+        }
+        _coro = std::exchange(other._coro, nullptr);
+        return *this;
+    }
+
+    ~batch_channel() {
+        if (_coro) {
+            _coro.destroy();
+        }
+    }
+
+    /// Determine whether the coroutine has finished executing
+    [[nodiscard]] bool done() const noexcept { return _coro.done(); }
+
+    /**
+     * @brief Launch the coroutine and run it until it has produced its first batch.
+     *
+     * The behavior of calling this function more than once is undefined.
+     */
+    [[nodiscard]] iterator begin() {
+        _refill(_coro);
+        return iterator{_coro};
+    }
+
+    constexpr std::default_sentinel_t end() const noexcept { return {}; }
+
+    /**
+     * @brief Discard the values of the prior batch (if any), and run the coroutine until it
+     * has produced another batch.
+     *
+     * @return A span of the values of the new batch, which remain alive until the next call.
+     * The consumer may move from the values. Returns an empty span once the coroutine has
+     * finished.
+     *
+     * If the coroutine exits with an exception, the exception is rethrown once all values
+     * yielded before it have been returned.
+     */
+    [[nodiscard]] std::span<T> next_batch() {
+        _refill(_coro);
+        auto& pr = _coro.promise();
+        return std::span<T>(pr._items, pr._size);
+    }
+};
+
+}  // namespace neo
@@ -0,0 +1,160 @@
+#include "./batch_channel.hpp"
+
+#include "./channel.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <std::size_t N>
+neo::batch_channel<int, N> count_to(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+template <typename Chan>
+auto collect(Chan&& ch) {
+    std::vector<typename std::remove_cvref_t<Chan>::yield_type> ret;
+    for (auto&& v : ch) {
+        ret.push_back(std::move(v));
+    }
+    return ret;
+}
+
+std::vector<int> iota(int n) {
+    std::vector<int> ret;
+    for (int i = 0; i < n; ++i) {
+        ret.push_back(i);
+    }
+    return ret;
+}
+
+}  // namespace
+
+static_assert(std::input_iterator<neo::batch_channel<int>::iterator>);
+static_assert(std::ranges::input_range<neo::batch_channel<int>>);
+
+TEST_CASE("Iterate a batch_channel") {
+    CHECK(collect(count_to<4>(0)).empty());
+    CHECK(collect(count_to<4>(1)) == iota(1));
+    CHECK(collect(count_to<4>(3)) == iota(3));
+    CHECK(collect(count_to<4>(4)) == iota(4));
+    CHECK(collect(count_to<4>(5)) == iota(5));
+    CHECK(collect(count_to<4>(100)) == iota(100));
+    CHECK(collect(count_to<1>(10)) == iota(10));
+}
+
+TEST_CASE("Consume a batch_channel a batch at a time") {
+    auto                     ch = count_to<4>(10);
+    std::vector<std::size_t> sizes;
+    std::vector<int>         all;
+    for (auto batch = ch.next_batch(); not batch.empty(); batch = ch.next_batch()) {
+        sizes.push_back(batch.size());
+        all.insert(all.end(), batch.begin(), batch.end());
+    }
+    CHECK(sizes == std::vector<std::size_t>{4, 4, 2});
+    CHECK(all == iota(10));
+    CHECK(ch.done());
+    // Asking again continues to return an empty batch
+    CHECK(ch.next_batch().empty());
+}
+
+TEST_CASE("batch_channel only resumes when the batch is full") {
+    int  n_resumed = 0;
+    auto fn        = [&]() -> neo::batch_channel<int, 8> {
+        for (int i = 0; i < 20; ++i) {
+            ++n_resumed;
+            co_yield i;
+        }
+    };
+    auto ch = fn();
+    auto it = ch.begin();
+    CHECK(n_resumed == 8);
+    for (int i = 0; i < 7; ++i) {
+        CHECK(*it == i);
+        ++it;
+    }
+    CHECK(n_resumed == 8);
+    ++it;
+    CHECK(*it == 8);
+    CHECK(n_resumed == 16);
+}
+
+TEST_CASE("Yield move-only values from a batch_channel") {
+    auto ch = []() -> neo::batch_channel<std::unique_ptr<std::string>, 2> {
+        co_yield std::make_unique<std::string>("foo");
+        co_yield std::make_unique<std::string>("bar");
+        co_yield std::make_unique<std::string>("baz");
+    }();
+    auto got = collect(ch);
+    REQUIRE(got.size() == 3);
+    CHECK(*got[0] == "foo");
+    CHECK(*got[1] == "bar");
+    CHECK(*got[2] == "baz");
+}
+
+TEST_CASE("batch_channel delivers buffered values before an exception") {
+    auto ch = []() -> neo::batch_channel<int, 8> {
+        co_yield 1;
+        co_yield 2;
+        throw std::runtime_error("oops");
+    }();
+    auto batch = ch.next_batch();
+    CHECK(batch.size() == 2);
+    CHECK_THROWS_AS(ch.next_batch(), std::runtime_error);
+    CHECK(ch.next_batch().empty());
+}
+
+TEST_CASE("batch_channel destroys buffered values") {
+    auto count = std::make_shared<int>(0);
+    {
+        auto ch = [](std::shared_ptr<int> c) -> neo::batch_channel<std::shared_ptr<int>, 4> {
+            for (int i = 0; i < 10; ++i) {
+                co_yield c;
+            }
+        }(count);
+        auto it = ch.begin();
+        // One reference in `count`, one held by the coroutine parameter, and four buffered
+        CHECK(count.use_count() == 6);
+        ++it;
+    }
+    CHECK(count.use_count() == 1);
+}
+
+namespace {
+
+neo::channel<int> count_chan(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Batched channel throughput", "[.][benchmark]") {
+    const int n_values = 10'000'000;
+    auto      measure  = [&](const char* name, auto&& ch) {
+        auto      start = std::chrono::steady_clock::now();
+        long long sum   = 0;
+        for (auto&& v : ch) {
+            sum += v;
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        CHECK(sum == (n_values - 1LL) * n_values / 2);
+        std::printf("%-24s %6.2f ns per value\n",
+                    name,
+                    std::chrono::duration<double, std::nano>(dur).count() / n_values);
+    };
+    measure("channel<int>", count_chan(n_values));
+    measure("batch_channel<int, 16>", count_to<16>(n_values));
+    measure("batch_channel<int, 64>", count_to<64>(n_values));
+    measure("batch_channel<int, 256>", count_to<256>(n_values));
+}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "./channel_fwd.hpp"
+#include "./coro_stop.hpp"
 
 #include <neo/addressof.hpp>
 #include <neo/attrib.hpp>
 #include <neo/concepts.hpp>
+#include <neo/frame_alloc.hpp>
 #include <neo/optional.hpp>
 #include <neo/unit.hpp>
 
@@ -27,20 +29,6 @@ struct from_chan_coro_getter {
     }
 };
 
-/**
- * @brief Abstract base class for send/yield handling
- *
- * @tparam T
- */
-template <typename T>
-class io_base {
-public:
-    /**
-     * @brief Push the referred-to value to the handler.
-     */
-    virtual void put(add_lvalue_reference_t<nonvoid_t<T>>) = 0;
-};
-
 /**
  * @brief Implements the return value aspect of channel
  *
@@ -53,7 +41,8 @@ struct return_part;
  * @brief Implements the yielding aspect channels. `T` must be `void` or an
  * lvalue-reference type. This type may be empty.
  *
- * Derives from io_base<T>. Defines a `get() -> nonvoid_t<T>&` method.
+ * Defines a `put(nonvoid_t<T>&)` method to store the yielded value, and a
+ * `get() -> nonvoid_t<T>&` method to retrieve it.
  */
 template <typename T>
 struct yield_io;
@@ -63,7 +52,8 @@ struct yield_io;
  * or an lvalue-reference type. This type must be constructed with a coroutine
  * handle.
  *
- * Derives from io_base<T>. Defines a `get() -> nonvoid_t<T>&` method.
+ * Defines a `put(nonvoid_t<T>&)` method to store the sent value and resume the
+ * coroutine, and a `get() -> nonvoid_t<T>&` method to retrieve the sent value.
  */
 template <typename T>
 struct send_io;
@@ -73,6 +63,9 @@ concept nested_channel_yield_compatible = requires {
     // The type being send to the outer channel should be convertible to the type that the inner
     // channel expects to be sent
     requires convertible_to<OuterSend, InnerSend>;
+    // Sent values are delivered directly to the innermost channel, so the channels must agree on
+    // the referred-to type of the sent value
+    requires same_as<add_lvalue_reference_t<OuterSend>, add_lvalue_reference_t<InnerSend>>;
     // The type yielded by the sub-channel must be convertible to the parent channel's yield type
     requires convertible_to<InnerYield, OuterYield>;
     // Passing the yield/send values through should not construct any references to temporary
@@ -83,9 +76,15 @@ concept nested_channel_yield_compatible = requires {
 
 /**
  * @brief Promise type for channels
+ *
+ * The coroutine frame is allocated using `frame_alloc_promise_base`: If the channel
+ * coroutine accepts `std::allocator_arg_t, Alloc` as its leading parameters, the
+ * frame will be allocated using that allocator, otherwise the frame is obtained
+ * from the thread's frame recycler.
  */
 template <typename Yield, typename Send, typename Return>
-class promise : public return_part<promise<Yield, Send, Return>> {
+class promise : public return_part<promise<Yield, Send, Return>>,
+                public frame_alloc_promise_base_for<"neo::channel"> {
     // The coroutine handle type for this promise
     using handle_type = std::coroutine_handle<promise>;
 
@@ -104,18 +103,21 @@ class promise : public return_part<promise<Yield, Send, Return>> {
      *
      * In the non-recursive case, this pointer always points to our own send-handler.
      * If the coroutine yields-from another channel<>, this pointer will be temporarily
-     * updated to point to the send-handler for that sub-channel.
+     * updated to point to the send-handler of the innermost active sub-channel, so
+     * sending a value resumes that sub-channel directly, regardless of the nesting
+     * depth.
      *
      * See `nested_awaiter` for where this pointer is manipulated.
      */
-    io_base<add_lvalue_reference_t<Send>>* _sender = &_self_sender;
+    send_io<add_lvalue_reference_t<Send>>* _sender = &_self_sender;
     /**
      * @brief Pointer to the yield-handler for the channel.
      *
      * Like the send-handler, this usually points to our own yield handler, but it
-     * may be updated by a parent coroutine in `nested_awaiter`.
+     * may be updated by a parent coroutine in `nested_awaiter`. If the parent has the
+     * same yield type, this points directly to the yield-handler of the root channel.
      */
-    io_base<add_lvalue_reference_t<Yield>>* _yielder = &_self_yielder;
+    yield_io<add_lvalue_reference_t<Yield>>* _yielder = &_self_yielder;
 
     /**
      * @brief Pointer-to-pointer-to the root sender for the current channel
@@ -123,7 +125,7 @@ class promise : public return_part<promise<Yield, Send, Return>> {
      * is used to update the `_sender` pointer on the root channel when a sub-channel
      * begins execution.
      */
-    io_base<add_lvalue_reference_t<Send>>** _root_sender_ptr = &_sender;
+    send_io<add_lvalue_reference_t<Send>>** _root_sender_ptr = &_sender;
 
     /**
      * @brief Information about the parent channel coroutine, if applicable.
@@ -132,6 +134,14 @@ class promise : public return_part<promise<Yield, Send, Return>> {
      */
     stack_resume_info* _parent = nullptr;
 
+    // The stop state for the channel stack, if we are the outermost channel.
+    coro_stop_detail::stop_state _self_stop;
+    /**
+     * @brief Pointer to the stop state of the outermost channel of the stack. Updated by a parent
+     * coroutine in `nested_awaiter`.
+     */
+    coro_stop_detail::stop_state* _stop = &_self_stop;
+
 public:
     // Conversion helper for the channel
     struct init {
@@ -163,10 +173,42 @@ public:
             // Don't rethrow, just stop:
             return;
         }
+        if (_stop->is_cancellation()) {
+            // The channel stack was unwound by a stop request. Finish quietly.
+            return;
+        }
         // No parent coroutine is running, so re-throw into the resumer
         throw;
     }
 
+    /// Whether a stop has been requested for this channel stack
+    bool stop_requested() const noexcept { return _stop->stop_requested(); }
+
+    /**
+     * @brief Request that the channel stack stop. If the channel is suspended, the innermost
+     * channel is resumed immediately, and its `co_yield` throws `coroutine_cancelled`.
+     */
+    void request_stop() {
+        _self_stop.request_stop();
+        if (not handle_type::from_promise(*this).done()) {
+            _sender->resumer.resume();
+        }
+    }
+
+    /// Request a stop for the channel stack when the given token is signalled
+    void attach_stop_token(std::stop_token tok) { _self_stop.attach(NEO_MOVE(tok)); }
+
+    /// Implements `co_await neo::this_stop_token`
+    auto await_transform(this_stop_token_t) {
+        return coro_stop_detail::stop_state::token_awaiter{_stop->get_token()};
+    }
+
+    // Other awaitables are passed through unchanged
+    template <typename Other>
+    constexpr Other&& await_transform(Other&& other) noexcept {
+        return NEO_FWD(other);
+    }
+
     // An awaitable used at the end of a channel to optionally resume a parent
     // channel, if present
     struct parent_resumer {
@@ -204,10 +246,12 @@ public:
         promise& self;
         YieldTmp yielded_value;
 
-        constexpr bool await_ready() const noexcept { return false; }
+        // If a stop was requested, no one will consume the value, so don't publish it
+        bool await_ready() const noexcept { return self._stop->stop_requested(); }
 
         /// Upon resumption, return the sent value that caused the resume:
-        Send await_resume() const noexcept {
+        Send await_resume() const {
+            self._stop->throw_if_stop_requested();
             return static_cast<add_rvalue_reference_t<Send>>(self._self_sender.get());
         }
 
@@ -287,40 +331,35 @@ public:
         // Resumption info that is used to coordinate with the sub-channel
         stack_resume_info resume_info{};
 
-        // We are only done if the sub-channel is already done
-        constexpr bool await_ready() const noexcept { return child_co_handle.done(); }
-
-        struct sender_link : io_base<add_lvalue_reference_t<Send>> {
-            io_base<add_lvalue_reference_t<OtherSend>>* _send_child;
+        // We are only done if the sub-channel is already done, or if the stack is stopping
+        constexpr bool await_ready() const noexcept {
+            return child_co_handle.done() or self._stop->stop_requested();
+        }
 
-            void put(add_lvalue_reference_t<nonvoid_t<Send>> s) { _send_child->put(s); }
-        };
+        // Whether the sub-channel can store its yielded values directly in our yield-handler
+        static constexpr bool direct_yield
+            = same_as<add_lvalue_reference_t<OtherYield>, add_lvalue_reference_t<Yield>>;
 
-        struct yielder_link : io_base<add_lvalue_reference_t<OtherYield>> {
-            io_base<add_lvalue_reference_t<Yield>>* _parent_yield;
+        // If the sub-channel yields a different type, values yielded by it pass through this
+        // link, which converts the reference and passes it up to our own yield-handler.
+        struct yielder_link : yield_io<add_lvalue_reference_t<OtherYield>> {
+            yield_io<add_lvalue_reference_t<Yield>>* _parent_yield = nullptr;
 
-            void put(nonvoid_t<OtherYield>& s) { _parent_yield->put(s); }
+            static void forward(yield_io<add_lvalue_reference_t<OtherYield>>& io) noexcept {
+                auto& self = static_cast<yielder_link&>(io);
+                self._parent_yield->put(io.get());
+            }
         };
 
-        sender_link  _sender2{};
-        yielder_link _yielder2{};
+        NEO_NO_UNIQUE_ADDRESS conditional_t<direct_yield, unit, yielder_link> _yielder2{};
 
-        io_base<add_lvalue_reference_t<OtherSend>>*
-        get_sender_link(io_base<add_lvalue_reference_t<OtherSend>>* child_sender) {
-            if constexpr (weak_same_as<OtherSend, Send>) {
-                return child_sender;
-            } else {
-                _sender2._send_child = child_sender;
-                return &_sender2;
-            }
-        }
-
-        io_base<add_lvalue_reference_t<OtherYield>>*
-        get_yielder_link(io_base<add_lvalue_reference_t<Yield>>* parent_yielder) {
-            if constexpr (weak_same_as<OtherYield, Yield>) {
+        yield_io<add_lvalue_reference_t<OtherYield>>*
+        get_yielder_link(yield_io<add_lvalue_reference_t<Yield>>* parent_yielder) noexcept {
+            if constexpr (direct_yield) {
                 return parent_yielder;
             } else {
                 _yielder2._parent_yield = parent_yielder;
+                _yielder2._forward      = &yielder_link::forward;
                 return &_yielder2;
             }
         }
@@ -334,7 +373,7 @@ public:
             // channel (or a parent thereof), the sent value will be immediately directed to the new
             // leaf channel, and that leaf channel will be resumed instead of the suspended parent
             // channels.
-            *self._root_sender_ptr = this->get_sender_link(child_pr._sender);
+            *self._root_sender_ptr = child_pr._sender;
             // Tell the sub-channel where the root sender-handler-pointer lives, in case it needs to
             // spawn any sub-channels of its own:
             child_pr._root_sender_ptr = self._root_sender_ptr;
@@ -343,6 +382,8 @@ public:
             child_pr._yielder = this->get_yielder_link(self._yielder);
             // Give the sub-channel a way to coordinate with this channel.
             child_pr._parent = &resume_info;
+            // Share the stop state of the channel stack
+            child_pr._stop = self._stop;
             // Tell the sub-channel our own coroutine handle so that it can resume us when it
             // returns.
             resume_info.co_handle = this_co;
@@ -360,6 +401,10 @@ public:
                 // The subchannel threw an exception during execution, so we should rethrow it too
                 std::rethrow_exception(resume_info.thrown);
             }
+            if (not child_co_handle.done()) {
+                // We never started the sub-channel, because the stack is stopping
+                throw coroutine_cancelled{};
+            }
             // Get the return value
             return static_cast<add_rvalue_reference_t<OtherReturn>>(
                 child_co_handle.promise().get_returned());
@@ -398,7 +443,7 @@ struct return_part<promise<Yield, Send, Return>> {
 };
 
 template <lvalue_reference_type Ref>
-struct send_io<Ref> : io_base<Ref> {
+struct send_io<Ref> {
     explicit send_io(std::coroutine_handle<> co) noexcept
         : resumer(co) {}
     add_pointer_t<Ref>      ptr;
@@ -412,28 +457,39 @@ struct send_io<Ref> : io_base<Ref> {
 };
 
 template <void_type Void>
-struct send_io<Void> : io_base<void> {
+struct send_io<Void> {
     explicit send_io(std::coroutine_handle<> co) noexcept
         : resumer(co) {}
 
     std::coroutine_handle<> resumer;
     static inline unit      nil;
 
-    void  put(unit&) override { resumer.resume(); }
+    void  put(unit&) { resumer.resume(); }
     unit& get() const noexcept { return nil; }
 };
 
 template <lvalue_reference_type T>
-struct yield_io<T> : io_base<T> {
+struct yield_io<T> {
     add_pointer_t<T> ptr;
-    void             put(T ref) override { ptr = NEO_ADDRESSOF(ref); }
+    /**
+     * @brief If non-null, called after each put() to pass the value along to a parent
+     * channel that yields a different type. Only set by `nested_awaiter`.
+     */
+    void (*_forward)(yield_io&) noexcept = nullptr;
+
+    void put(T ref) noexcept {
+        ptr = NEO_ADDRESSOF(ref);
+        if (_forward) {
+            _forward(*this);
+        }
+    }
 
     T get() const noexcept { return *ptr; }
 };
 
 template <void_type T>
-struct yield_io<T> : io_base<void> {
-    void put(unit&) override {}
+struct yield_io<T> {
+    void put(unit&) noexcept {}
 
     static inline unit nil;
     unit&              get() const noexcept { return nil; }
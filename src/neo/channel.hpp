@@ -8,6 +8,7 @@
 #include <neo/unit.hpp>
 
 #include <coroutine>
+#include <stop_token>
 #include <type_traits>
 
 namespace neo {
@@ -37,6 +38,15 @@ namespace neo {
  *
  * Channel coroutines may also co_yield other channels, using the `from_channel`
  * wrapper.
+ *
+ * For one-way producers of many small values, `batch_channel` avoids switching
+ * coroutines for every value.
+ *
+ * A channel stack may be cancelled with `channel_pipe::request_stop()`, or by opening it
+ * with a `std::stop_token`. Once a stop is requested, the next `co_yield` in the innermost
+ * channel throws `neo::coroutine_cancelled` without publishing its value. The exception
+ * unwinds the nested channels, and the outermost channel finishes without a return value.
+ * Channel coroutines may poll for a stop using `co_await neo::this_stop_token`.
  */
 template <typename Yield, typename Send, typename Return>
 class channel {
@@ -71,6 +81,18 @@ public:
         return pipe_type(_coro);
     }
 
+    /**
+     * @brief Launch the channel, requesting a stop of the channel stack when the given token
+     * is signalled.
+     *
+     * A stop from the token is observed at the next `co_yield` within the channel stack, or
+     * through `co_await neo::this_stop_token`.
+     */
+    pipe_type open(std::stop_token tok) {
+        _coro.promise().attach_stop_token(NEO_MOVE(tok));
+        return open();
+    }
+
     // Destroy
     NEO_CONSTEXPR_DESTRUCTOR ~channel() {
         if (_coro) {
@@ -190,6 +212,19 @@ public:
      */
     constexpr bool done() const noexcept { return _coro.done(); }
 
+    /**
+     * @brief Request that the channel stack stop.
+     *
+     * The innermost channel is resumed immediately, and its `co_yield` throws
+     * `neo::coroutine_cancelled`, which unwinds the stack. Afterwards, `done()` is `true`,
+     * unless a channel caught the exception and did not rethrow it. If the channel
+     * completes due to the stop, it has no return value.
+     */
+    void request_stop() { _coro.promise().request_stop(); }
+
+    /// Whether a stop has been requested for the channel
+    [[nodiscard]] bool stop_requested() const noexcept { return _coro.promise().stop_requested(); }
+
     /**
      * @brief Obtain the most-recently yielded value from the channel.
      *
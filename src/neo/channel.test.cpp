@@ -5,7 +5,10 @@
 #include <neo/assert.hpp>
 #include <neo/config-pp.hpp>
 #include <neo/coroutine.hpp>
+#include <neo/testing.hpp>
 
+#include <chrono>
+#include <cstdio>
 #include <ranges>
 #include <stdexcept>
 
@@ -436,3 +439,197 @@ TEST_CASE("Reference conversion") {
     io.send();
     CHECK(io.current() == "fin");
 }
+
+using neo::testing::counting_allocator;
+
+namespace {
+
+channel<int> allocated_chan(std::allocator_arg_t, counting_allocator<int>, int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Channel with an allocator") {
+    testing::alloc_stats stats;
+    auto                 ch = allocated_chan(std::allocator_arg, counting_allocator<int>{stats}, 3);
+    CHECK(stats.n_allocs == 1);
+    std::vector<int> nums;
+    std::ranges::copy(ch, std::back_inserter(nums));
+    CHECK(nums == std::vector<int>{0, 1, 2});
+}
+
+namespace {
+
+struct animal {
+    std::string name;
+};
+
+struct dog : animal {};
+
+channel<dog&, int> dogs(int n) {
+    dog d;
+    for (int i = 0; i < n; ++i) {
+        d.name  = "dog";
+        int got = co_yield d;
+        CHECK(got == i);
+    }
+}
+
+channel<dog&, int> more_dogs(int n) { co_yield *dogs(n); }
+
+channel<animal&, int> animals(int n) {
+    animal a{"cat"};
+    int    got = co_yield a;
+    CHECK(got == -1);
+    co_yield *more_dogs(n);
+    got = co_yield a;
+    CHECK(got == -2);
+}
+
+channel<const animal&, int> const_animals(int n) { co_yield *animals(n); }
+
+}  // namespace
+
+TEST_CASE("Nested yield conversions") {
+    auto ch = const_animals(3);
+    auto io = ch.open();
+    CHECK(io.current().name == "cat");
+    io.send(-1);
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE_FALSE(io.done());
+        CHECK(io.current().name == "dog");
+        io.send(i);
+    }
+    CHECK(io.current().name == "cat");
+    io.send(-2);
+    CHECK(io.done());
+}
+
+namespace {
+
+channel<int, int> nested_counter(int depth, int n) {
+    if (depth == 0) {
+        for (int i = 0; i < n; ++i) {
+            co_yield i;
+        }
+    } else {
+        co_yield *nested_counter(depth - 1, n);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Nested channel throughput", "[.][benchmark]") {
+    // Sending to and yielding from a nested channel resumes the innermost channel directly, so the
+    // cost per value should not depend on the nesting depth.
+    for (int depth : {1, 8, 64}) {
+        const int n_values = 1'000'000;
+        auto      ch       = nested_counter(depth, n_values);
+        auto      start    = std::chrono::steady_clock::now();
+        auto      io       = ch.open();
+        long long sum      = 0;
+        while (not io.done()) {
+            sum += io.current();
+            io.send(0);
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        CHECK(sum == (n_values - 1LL) * n_values / 2);
+        std::printf("Nesting depth %2d: %6.2f ns per value\n",
+                    depth,
+                    std::chrono::duration<double, std::nano>(dur).count() / n_values);
+    }
+}
+
+namespace {
+
+// Counts live instances, to check that cancellation runs destructors
+struct live_counter {
+    int* n;
+    explicit live_counter(int& n_)
+        : n(&n_) {
+        ++*n;
+    }
+    ~live_counter() { --*n; }
+};
+
+channel<int, void> counting_forever(int& n_live, int& n_produced) {
+    live_counter guard{n_live};
+    for (int i = 0;; ++i) {
+        ++n_produced;
+        co_yield i;
+    }
+}
+
+channel<int, void, int> cancel_outer(int& n_live, int& n_produced) {
+    live_counter guard{n_live};
+    co_yield *counting_forever(n_live, n_produced);
+    // Never reached: The nested channel never returns
+    co_return 42;
+}
+
+}  // namespace
+
+TEST_CASE("Stop a nested channel stack") {
+    int  n_live     = 0;
+    int  n_produced = 0;
+    auto ch         = cancel_outer(n_live, n_produced);
+    auto io         = ch.open();
+    CHECK(n_live == 2);
+    CHECK(io.current() == 0);
+    io.send();
+    CHECK(io.current() == 1);
+    CHECK_FALSE(io.stop_requested());
+    io.request_stop();
+    CHECK(io.stop_requested());
+    CHECK(io.done());
+    // Both channels were unwound
+    CHECK(n_live == 0);
+    CHECK(n_produced == 2);
+}
+
+TEST_CASE("Stop a channel from a std::stop_source") {
+    std::stop_source src;
+    auto             ch = []() -> channel<int, void, int> {
+        auto tok = co_await neo::this_stop_token;
+        int  n   = 0;
+        while (not tok.stop_requested()) {
+            co_yield n++;
+        }
+        // Stopped while polling, so we get to return normally
+        co_return n;
+    }();
+    auto io = ch.open(src.get_token());
+    CHECK(io.current() == 0);
+    io.send();
+    CHECK(io.current() == 1);
+    src.request_stop();
+    CHECK(io.stop_requested());
+    // The stop is observed at the next co_yield, so the value is not produced
+    io.send();
+    CHECK(io.done());
+}
+
+TEST_CASE("Stopped before the channel is opened") {
+    std::stop_source src;
+    src.request_stop();
+    int  n_live     = 0;
+    int  n_produced = 0;
+    auto ch         = cancel_outer(n_live, n_produced);
+    auto io         = ch.open(src.get_token());
+    CHECK(io.done());
+    CHECK(n_live == 0);
+    // The inner channel was never started
+    CHECK(n_produced == 0);
+}
+
+TEST_CASE("Cancellation is only swallowed after a stop") {
+    auto ch = []() -> channel<int, void> {
+        co_yield 1;
+        throw neo::coroutine_cancelled{};
+    }();
+    auto io = ch.open();
+    CHECK_THROWS_AS(io.send(), neo::coroutine_cancelled);
+}
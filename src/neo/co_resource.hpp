@@ -11,6 +11,7 @@
 #endif
 
 #include "./addressof.hpp"
+#include "./frame_alloc.hpp"
 #include "./type_traits.hpp"
 
 #include <coroutine>
@@ -30,7 +31,7 @@ struct init {
 
 /// Common base of the promise type
 template <typename T>
-struct promise_base {
+struct promise_base : frame_alloc_promise_base_for<"neo::co_resource"> {
     auto get_return_object() noexcept {
         return init<T>{
             std::coroutine_handle<promise<T>>::from_promise(static_cast<promise<T>&>(*this))};
@@ -7,3 +7,11 @@
 #ifndef Neo_ToggleFeature_TerseLambdaMSVCNoexceptWorkaround
 #define Neo_ToggleFeature_TerseLambdaMSVCNoexceptWorkaround Disabled
 #endif
+
+#ifndef Neo_ToggleFeature_CoroFrameStats
+#define Neo_ToggleFeature_CoroFrameStats Disabled
+#endif
+
+#ifndef Neo_ToggleFeature_EventStats
+#define Neo_ToggleFeature_EventStats Disabled
+#endif
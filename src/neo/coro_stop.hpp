@@ -0,0 +1,136 @@
+#pragma once
+
+#include "./fwd.hpp"
+
+#include <exception>
+#include <memory>
+#include <stop_token>
+
+namespace neo {
+
+/**
+ * @brief Thrown from a `co_yield` expression within a channel or generator when a stop
+ * has been requested for the coroutine stack.
+ *
+ * The exception unwinds each nested coroutine in turn, and is swallowed by the outermost
+ * coroutine, which then finishes as if it had returned. A coroutine may catch the exception
+ * to perform cleanup, but should then rethrow it.
+ */
+class coroutine_cancelled : public std::exception {
+public:
+    const char* what() const noexcept override { return "neo::coroutine_cancelled"; }
+};
+
+/// The type of `this_stop_token`
+struct this_stop_token_t {
+    explicit this_stop_token_t() = default;
+};
+
+/**
+ * @brief Within a channel or generator coroutine, `co_await neo::this_stop_token` evaluates
+ * to a `std::stop_token` that is signalled when a stop is requested for the coroutine stack.
+ *
+ * This allows a coroutine to poll for cancellation (or to pass the token along to other
+ * operations) between yields.
+ */
+inline constexpr this_stop_token_t this_stop_token{};
+
+namespace coro_stop_detail {
+
+/**
+ * @brief The stop state of a stack of nested coroutines. Lives in the outermost coroutine.
+ *
+ * A `std::stop_source` is only created when it is first needed, either because the coroutine
+ * asked for its stop token, or because an external stop token was attached. Otherwise,
+ * requesting a stop only sets a flag.
+ */
+class stop_state {
+    // Forwards a stop request from an attached token to our own source
+    struct forward_stop {
+        stop_state* self;
+        void        operator()() const noexcept { self->_source.request_stop(); }
+    };
+
+    bool             _requested = false;
+    std::stop_source _source{std::nostopstate};
+    // Attaching an external token is rare, so keep the callback out of the coroutine frame
+    std::unique_ptr<std::stop_callback<forward_stop>> _link;
+
+    void _ensure_source() {
+        if (not _source.stop_possible()) {
+            _source = std::stop_source{};
+            if (_requested) {
+                _source.request_stop();
+            }
+        }
+    }
+
+public:
+    stop_state() = default;
+    // The attached callback refers to us
+    stop_state(const stop_state&) = delete;
+
+    /// Request a stop if the given token is signalled
+    void attach(std::stop_token tok) {
+        if (tok.stop_possible()) {
+            _ensure_source();
+            _link = std::make_unique<std::stop_callback<forward_stop>>(NEO_MOVE(tok),
+                                                                       forward_stop{this});
+        }
+    }
+
+    void request_stop() noexcept {
+        _requested = true;
+        if (_source.stop_possible()) {
+            _source.request_stop();
+        }
+    }
+
+    [[nodiscard]] bool stop_requested() const noexcept {
+        return _requested or _source.stop_requested();
+    }
+
+    [[nodiscard]] std::stop_token get_token() {
+        _ensure_source();
+        return _source.get_token();
+    }
+
+    /// Throw coroutine_cancelled if a stop was requested
+    void throw_if_stop_requested() const {
+        if (stop_requested()) {
+            throw coroutine_cancelled{};
+        }
+    }
+
+    /**
+     * @brief Called from the outermost coroutine's `unhandled_exception()`.
+     *
+     * @return `true` if the in-flight exception is a coroutine_cancelled that was caused
+     * by a stop request, and should be swallowed.
+     */
+    bool is_cancellation() const noexcept {
+        if (not stop_requested()) {
+            return false;
+        }
+        try {
+            throw;
+        } catch (const coroutine_cancelled&) {
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    /// The awaiter for `co_await this_stop_token`
+    struct token_awaiter {
+        std::stop_token token;
+
+        constexpr bool  await_ready() const noexcept { return true; }
+        constexpr void  await_suspend(auto) const noexcept {}
+        std::stop_token await_resume() noexcept { return NEO_MOVE(token); }
+    };
+};
+
+}  // namespace coro_stop_detail
+
+}  // namespace neo
@@ -0,0 +1,344 @@
+#include "./platform.hpp"
+
+#if NEO_OS_IS_LINUX
+
+#include "./epoll_reactor.hpp"
+
+#include "./assert.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace neo;
+using reactor_detail::fd_state;
+using reactor_detail::io_op;
+
+namespace {
+
+[[noreturn]] void throw_errno(int err, const char* what) {
+    throw std::system_error(err, std::system_category(), what);
+}
+
+/// Record the errno of a failed operation. Returns `false` if the operation would block.
+bool finish_with_errno(io_op& op) noexcept {
+    if (errno == EAGAIN or errno == EWOULDBLOCK) {
+        return false;
+    }
+    op.error = errno;
+    return true;
+}
+
+}  // namespace
+
+void reactor_detail::throw_if_error(int err, const char* what) {
+    if (err != 0) {
+        throw_errno(err, what);
+    }
+}
+
+epoll_reactor::epoll_reactor() {
+    _epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        throw_errno(errno, "epoll_create1()");
+    }
+    _wake_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_wake_fd < 0) {
+        auto err = errno;
+        ::close(_epoll_fd);
+        throw_errno(err, "eventfd()");
+    }
+    ::epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = _wake_fd;
+    if (::epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_fd, &ev) != 0) {
+        auto err = errno;
+        ::close(_wake_fd);
+        ::close(_epoll_fd);
+        throw_errno(err, "epoll_ctl()");
+    }
+}
+
+epoll_reactor::~epoll_reactor() {
+    ::close(_wake_fd);
+    ::close(_epoll_fd);
+}
+
+void epoll_reactor::_rearm(int fd, fd_state& st) {
+    ::epoll_event ev{};
+    ev.events  = EPOLLONESHOT | (st.reader ? EPOLLIN : 0u) | (st.writer ? EPOLLOUT : 0u);
+    ev.data.fd = fd;
+    // The registration may be stale if the file descriptor was closed and reused, so fall
+    // back between ADD and MOD.
+    auto op = st.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (::epoll_ctl(_epoll_fd, op, fd, &ev) != 0) {
+        if (errno == ENOENT) {
+            op = EPOLL_CTL_ADD;
+        } else if (errno == EEXIST) {
+            op = EPOLL_CTL_MOD;
+        } else {
+            throw_errno(errno, "epoll_ctl()");
+        }
+        if (::epoll_ctl(_epoll_fd, op, fd, &ev) != 0) {
+            throw_errno(errno, "epoll_ctl()");
+        }
+    }
+    st.registered = true;
+}
+
+void epoll_reactor::_wait(int fd, io_op& op, bool write) {
+    auto& st   = _fds[fd];
+    auto& slot = write ? st.writer : st.reader;
+    neo_assert(expects,
+               slot == nullptr,
+               "More than one coroutine is waiting on the same socket in the same direction",
+               fd,
+               write);
+    slot = &op;
+    try {
+        _rearm(fd, st);
+    } catch (...) {
+        slot = nullptr;
+        throw;
+    }
+    ++_n_waiting;
+}
+
+void epoll_reactor::_post(std::coroutine_handle<> co) {
+    {
+        std::scoped_lock lk{_post_mtx};
+        _posted.push_back(co);
+    }
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(_wake_fd, &one, sizeof one);
+}
+
+reactor_detail::detached epoll_reactor::_spawn(epoll_reactor& r, task<> t) {
+    co_await r.schedule();
+    co_await t;
+}
+
+void epoll_reactor::close(int fd) noexcept {
+    auto it = _fds.find(fd);
+    if (it != _fds.end()) {
+        neo_assert(expects,
+                   it->second.reader == nullptr and it->second.writer == nullptr,
+                   "Closing a socket while a coroutine is waiting on it",
+                   fd);
+        _fds.erase(it);
+    }
+    ::close(fd);
+}
+
+void epoll_reactor::cancel(int fd) {
+    auto it = _fds.find(fd);
+    if (it == _fds.end()) {
+        return;
+    }
+    // Take both operations first, since resuming a coroutine may close the socket
+    io_op* ops[] = {std::exchange(it->second.reader, nullptr),
+                    std::exchange(it->second.writer, nullptr)};
+    for (auto op : ops) {
+        if (op) {
+            op->error = ECANCELED;
+            --_n_waiting;
+            op->co.resume();
+        }
+    }
+}
+
+void epoll_reactor::stop() noexcept {
+    _stop.store(true, std::memory_order_release);
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(_wake_fd, &one, sizeof one);
+}
+
+void epoll_reactor::_check_stalled() noexcept {
+    std::scoped_lock lk{_post_mtx};
+    neo_assert(expects,
+               _n_waiting != 0 or not _posted.empty(),
+               "epoll_reactor::run() is waiting on a coroutine that is not waiting for any "
+               "operation of the epoll_reactor");
+}
+
+std::size_t epoll_reactor::run_one(int timeout_ms) {
+    std::size_t n_resumed = 0;
+
+    ::epoll_event events[64];
+    int           n_events = ::epoll_wait(_epoll_fd, events, 64, timeout_ms);
+    if (n_events < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        throw_errno(errno, "epoll_wait()");
+    }
+
+    // Collect completed operations before resuming anything, since resumed coroutines may
+    // register new operations.
+    io_op* completed[64 * 2];
+    int    n_completed = 0;
+    bool   woken       = false;
+    for (auto& ev : std::span(events, static_cast<std::size_t>(n_events))) {
+        const int fd = ev.data.fd;
+        if (fd == _wake_fd) {
+            woken = true;
+            continue;
+        }
+        auto it = _fds.find(fd);
+        if (it == _fds.end()) {
+            continue;
+        }
+        auto&      st    = it->second;
+        const bool error = ev.events & (EPOLLERR | EPOLLHUP);
+        if (st.reader and (error or (ev.events & EPOLLIN))) {
+            if (st.reader->attempt(*st.reader)) {
+                completed[n_completed++] = std::exchange(st.reader, nullptr);
+            }
+        }
+        if (st.writer and (error or (ev.events & EPOLLOUT))) {
+            if (st.writer->attempt(*st.writer)) {
+                completed[n_completed++] = std::exchange(st.writer, nullptr);
+            }
+        }
+        if (st.reader or st.writer) {
+            _rearm(fd, st);
+        }
+    }
+
+    _n_waiting -= static_cast<std::size_t>(n_completed);
+    for (auto op : std::span(completed, static_cast<std::size_t>(n_completed))) {
+        op->co.resume();
+        ++n_resumed;
+    }
+
+    if (woken) {
+        std::uint64_t count;
+        [[maybe_unused]] auto n = ::read(_wake_fd, &count, sizeof count);
+        std::vector<std::coroutine_handle<>> posted;
+        {
+            std::scoped_lock lk{_post_mtx};
+            posted.swap(_posted);
+        }
+        for (auto co : posted) {
+            co.resume();
+            ++n_resumed;
+        }
+    }
+    return n_resumed;
+}
+
+void epoll_reactor::run() {
+    while (not _stop.exchange(false, std::memory_order_acq_rel)) {
+        run_one();
+    }
+}
+
+task<> epoll_reactor::send_all(int fd, std::span<const std::byte> buf) {
+    while (not buf.empty()) {
+        auto n = co_await send(fd, buf);
+        buf    = buf.subspan(n);
+    }
+}
+
+bool epoll_reactor::accept_awaiter::attempt_fn(io_op& self_) noexcept {
+    auto& self  = static_cast<accept_awaiter&>(self_);
+    self.result = ::accept4(self.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (self.result < 0) {
+        return finish_with_errno(self);
+    }
+    return true;
+}
+
+int epoll_reactor::accept_awaiter::await_resume() const {
+    reactor_detail::throw_if_error(error, "accept()");
+    return result;
+}
+
+bool epoll_reactor::connect_awaiter::attempt_fn(io_op& self_) noexcept {
+    auto& self = static_cast<connect_awaiter&>(self_);
+    if (not self.started) {
+        self.started = true;
+        if (::connect(self.fd, self.addr, self.addr_len) == 0) {
+            return true;
+        }
+        if (errno == EINPROGRESS) {
+            // Wait for the socket to become writable
+            return false;
+        }
+        self.error = errno;
+        return true;
+    }
+    // The socket became writable. Check whether the connection succeeded.
+    int         err = 0;
+    ::socklen_t len = sizeof err;
+    if (::getsockopt(self.fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) {
+        err = errno;
+    }
+    self.error = err;
+    return true;
+}
+
+void epoll_reactor::connect_awaiter::await_resume() const {
+    reactor_detail::throw_if_error(error, "connect()");
+}
+
+bool epoll_reactor::recv_awaiter::attempt_fn(io_op& self_) noexcept {
+    auto&      self = static_cast<recv_awaiter&>(self_);
+    const auto n    = ::recv(self.fd, self.buf.data(), self.buf.size(), 0);
+    if (n < 0) {
+        return finish_with_errno(self);
+    }
+    self.result = static_cast<std::size_t>(n);
+    return true;
+}
+
+std::size_t epoll_reactor::recv_awaiter::await_resume() const {
+    reactor_detail::throw_if_error(error, "recv()");
+    return result;
+}
+
+bool epoll_reactor::send_awaiter::attempt_fn(io_op& self_) noexcept {
+    auto&      self = static_cast<send_awaiter&>(self_);
+    const auto n    = ::send(self.fd, self.buf.data(), self.buf.size(), MSG_NOSIGNAL);
+    if (n < 0) {
+        return finish_with_errno(self);
+    }
+    self.result = static_cast<std::size_t>(n);
+    return true;
+}
+
+std::size_t epoll_reactor::send_awaiter::await_resume() const {
+    reactor_detail::throw_if_error(error, "send()");
+    return result;
+}
+
+epoll_reactor_pool::epoll_reactor_pool(std::size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = std::thread::hardware_concurrency();
+    }
+    if (n_threads == 0) {
+        n_threads = 1;
+    }
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        _reactors.push_back(std::make_unique<epoll_reactor>());
+    }
+    for (auto& r : _reactors) {
+        _threads.emplace_back([&r = *r] { r.run(); });
+    }
+}
+
+epoll_reactor_pool::~epoll_reactor_pool() {
+    for (auto& r : _reactors) {
+        r->stop();
+    }
+    for (auto& t : _threads) {
+        t.join();
+    }
+}
+
+#endif  // NEO_OS_IS_LINUX
@@ -0,0 +1,374 @@
+#pragma once
+
+#include "./platform.hpp"
+
+#if (defined(__dds_header_check) || defined(__bpt_header_check)) && !NEO_OS_IS_LINUX
+// Elide this file
+#else
+
+#if !NEO_OS_IS_LINUX
+#error "<neo/epoll_reactor.hpp> is only available on Linux"
+#endif
+
+#include "./await.hpp"
+#include "./await_driver.hpp"
+#include "./fwd.hpp"
+#include "./task.hpp"
+#include "./type_traits.hpp"
+#include "./unit.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
+
+namespace neo {
+
+class epoll_reactor;
+
+namespace reactor_detail {
+
+/**
+ * @brief A coroutine that starts immediately and destroys itself when it finishes. An
+ * exception escaping the coroutine terminates the program.
+ */
+struct detached {
+    struct promise_type {
+        detached           get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void               return_void() const noexcept {}
+        [[noreturn]] void  unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * @brief A non-blocking socket operation that is waiting for its file descriptor to
+ * become ready.
+ */
+struct io_op {
+    /// Attempt the operation. Returns `false` if it would block.
+    bool (*attempt)(io_op& self) noexcept;
+    /// The coroutine to resume once the operation completes
+    std::coroutine_handle<> co;
+    /// The errno of the operation, or zero
+    int error = 0;
+};
+
+/// Throw a std::system_error for a failed operation, if `err` is non-zero
+void throw_if_error(int err, const char* what);
+
+/// Registration state of a file descriptor with the reactor
+struct fd_state {
+    io_op* reader     = nullptr;
+    io_op* writer     = nullptr;
+    bool   registered = false;
+};
+
+}  // namespace reactor_detail
+
+/**
+ * @brief A single-threaded event loop that resumes coroutines when their non-blocking
+ * sockets become ready, using Linux epoll.
+ *
+ * Socket operations such as `recv()` and `send()` return awaitables. Each is first
+ * attempted immediately, and only suspends if it would block. A suspended coroutine is
+ * resumed by `run()`/`run_one()` on the thread running the reactor, once the operation has
+ * completed.
+ *
+ * The sockets must be in non-blocking mode. At most one coroutine may wait to read and one
+ * coroutine may wait to write on a given socket at a time.
+ *
+ * `schedule()`, `spawn()`, and `stop()` may be called from any thread. All other member
+ * functions must only be called on the thread that runs the reactor. To run several
+ * reactors on several threads, see `epoll_reactor_pool`.
+ */
+class epoll_reactor {
+    int _epoll_fd = -1;
+    int _wake_fd  = -1;
+
+    std::unordered_map<int, reactor_detail::fd_state> _fds;
+    // The number of operations waiting for readiness
+    std::size_t _n_waiting = 0;
+
+    // Coroutines posted from (possibly) other threads
+    std::mutex                           _post_mtx;
+    std::vector<std::coroutine_handle<>> _posted;
+    std::atomic<bool>                    _stop{false};
+
+    void _wait(int fd, reactor_detail::io_op& op, bool write);
+    void _rearm(int fd, reactor_detail::fd_state& st);
+    void _post(std::coroutine_handle<> co);
+    void _check_stalled() noexcept;
+
+    static reactor_detail::detached _spawn(epoll_reactor& r, task<> t);
+
+    /// Common base of the socket operation awaitables
+    template <typename Derived, bool Write>
+    struct op_awaiter : reactor_detail::io_op {
+        epoll_reactor& reactor;
+        int            fd;
+
+        op_awaiter(epoll_reactor& r, int fd) noexcept
+            : io_op{&Derived::attempt_fn, nullptr, 0}
+            , reactor(r)
+            , fd(fd) {}
+
+        bool await_ready() noexcept { return attempt(*this); }
+        void await_suspend(std::coroutine_handle<> h) {
+            co = h;
+            reactor._wait(fd, *this, Write);
+        }
+    };
+
+public:
+    /**
+     * @brief Create a new reactor.
+     *
+     * @throw std::system_error If the epoll instance cannot be created
+     */
+    epoll_reactor();
+    ~epoll_reactor();
+
+    epoll_reactor(const epoll_reactor&)            = delete;
+    epoll_reactor& operator=(const epoll_reactor&) = delete;
+
+    /// Awaitable returned by `accept()`
+    struct [[nodiscard]] accept_awaiter : op_awaiter<accept_awaiter, false> {
+        int         result = -1;
+        static bool attempt_fn(reactor_detail::io_op& self) noexcept;
+        using op_awaiter::op_awaiter;
+        int await_resume() const;
+    };
+
+    /// Awaitable returned by `connect()`
+    struct [[nodiscard]] connect_awaiter : op_awaiter<connect_awaiter, true> {
+        const ::sockaddr* addr;
+        ::socklen_t       addr_len;
+        bool              started = false;
+        static bool       attempt_fn(reactor_detail::io_op& self) noexcept;
+        connect_awaiter(epoll_reactor& r, int fd, const ::sockaddr* a, ::socklen_t len) noexcept
+            : op_awaiter(r, fd)
+            , addr(a)
+            , addr_len(len) {}
+        void await_resume() const;
+    };
+
+    /// Awaitable returned by `recv()`
+    struct [[nodiscard]] recv_awaiter : op_awaiter<recv_awaiter, false> {
+        std::span<std::byte> buf;
+        std::size_t          result = 0;
+        static bool          attempt_fn(reactor_detail::io_op& self) noexcept;
+        recv_awaiter(epoll_reactor& r, int fd, std::span<std::byte> b) noexcept
+            : op_awaiter(r, fd)
+            , buf(b) {}
+        std::size_t await_resume() const;
+    };
+
+    /// Awaitable returned by `send()`
+    struct [[nodiscard]] send_awaiter : op_awaiter<send_awaiter, true> {
+        std::span<const std::byte> buf;
+        std::size_t                result = 0;
+        static bool                attempt_fn(reactor_detail::io_op& self) noexcept;
+        send_awaiter(epoll_reactor& r, int fd, std::span<const std::byte> b) noexcept
+            : op_awaiter(r, fd)
+            , buf(b) {}
+        std::size_t await_resume() const;
+    };
+
+    /// Awaitable returned by `schedule()`
+    struct schedule_awaiter {
+        epoll_reactor& reactor;
+
+        constexpr bool await_ready() const noexcept { return false; }
+        void           await_suspend(std::coroutine_handle<> co) const { reactor._post(co); }
+        constexpr void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Accept a connection on a listening socket.
+     *
+     * The result of the `co_await` is the new socket, which is non-blocking and close-on-exec.
+     */
+    accept_awaiter accept(int listen_fd) noexcept { return accept_awaiter{*this, listen_fd}; }
+
+    /**
+     * @brief Connect a socket to the given address.
+     *
+     * The address must remain valid until the `co_await` completes.
+     */
+    connect_awaiter connect(int fd, const ::sockaddr* addr, ::socklen_t addr_len) noexcept {
+        return connect_awaiter{*this, fd, addr, addr_len};
+    }
+
+    /**
+     * @brief Receive data from a socket into the given buffer.
+     *
+     * The result of the `co_await` is the number of bytes received, which is zero if the peer
+     * has shut down the connection.
+     */
+    recv_awaiter recv(int fd, std::span<std::byte> buf) noexcept {
+        return recv_awaiter{*this, fd, buf};
+    }
+
+    /**
+     * @brief Send data from the given buffer on a socket.
+     *
+     * The result of the `co_await` is the number of bytes sent, which may be less than the
+     * size of the buffer.
+     */
+    send_awaiter send(int fd, std::span<const std::byte> buf) noexcept {
+        return send_awaiter{*this, fd, buf};
+    }
+
+    /**
+     * @brief Send all of the given data on a socket.
+     */
+    task<> send_all(int fd, std::span<const std::byte> buf);
+
+    /**
+     * @brief Return an awaitable that, when awaited, suspends the current coroutine and
+     * resumes it on the thread that is running this reactor.
+     */
+    [[nodiscard]] schedule_awaiter schedule() noexcept { return schedule_awaiter{*this}; }
+
+    /**
+     * @brief Start the given task on the thread that is running this reactor, without
+     * waiting for it to complete. The task must not throw.
+     */
+    void spawn(task<> t) { _spawn(*this, NEO_MOVE(t)); }
+
+    /**
+     * @brief Complete the operations waiting on the given file descriptor with an error of
+     * `ECANCELED`. The waiting coroutines are resumed before this function returns.
+     *
+     * This is useful to abandon an operation after a timeout, before closing the socket.
+     */
+    void cancel(int fd);
+
+    /**
+     * @brief Forget the given file descriptor and close it.
+     *
+     * @pre No coroutine may be waiting on the file descriptor.
+     */
+    void close(int fd) noexcept;
+
+    /**
+     * @brief Wait for events and resume the coroutines of completed operations.
+     *
+     * @param timeout_ms The maximum time to wait, in milliseconds. Negative to wait
+     * indefinitely, or zero to only poll.
+     * @return The number of coroutines that were resumed.
+     */
+    std::size_t run_one(int timeout_ms = -1);
+
+    /**
+     * @brief Run the reactor on the calling thread until `stop()` is called.
+     */
+    void run();
+
+    /**
+     * @brief Await the given awaitable on the calling thread, running the reactor until it
+     * completes.
+     *
+     * @pre The awaitable must only wait on operations of this reactor.
+     */
+    template <awaitable A>
+    await_result_t<A> run(A&& a);
+
+    /**
+     * @brief Cause `run()` to return. May be called from any thread.
+     */
+    void stop() noexcept;
+};
+
+template <awaitable A>
+await_result_t<A> epoll_reactor::run(A&& a) {
+    auto d = await_driver_detail::make_driver<await_result_t<A>>(NEO_FWD(a));
+    d.start();
+    while (not d.done()) {
+        _check_stalled();
+        run_one();
+    }
+    return d.take();
+}
+
+/**
+ * @brief Receive data from a socket and send each chunk into a channel pipe.
+ *
+ * This lets a channel coroutine that consumes `std::span<const std::byte>` (such as a
+ * message parser) be fed from a socket. When the peer shuts down the connection, an empty
+ * span is sent to mark the end of the stream.
+ *
+ * @param reactor The reactor to wait on
+ * @param fd A non-blocking socket to read from
+ * @param pipe A pipe whose `send()` accepts a `std::span<const std::byte>`
+ * @param buf_size The maximum size of each chunk
+ * @return The total number of bytes received. Stops early if the channel finishes.
+ */
+template <typename Pipe>
+    requires requires(Pipe& p, std::span<const std::byte> s) {
+        p.send(s);
+        p.done();
+    }
+task<std::size_t>
+recv_into_channel(epoll_reactor& reactor, int fd, Pipe& pipe, std::size_t buf_size = 4096) {
+    std::vector<std::byte> buf(buf_size);
+    std::size_t            total = 0;
+    while (not pipe.done()) {
+        auto n = co_await reactor.recv(fd, buf);
+        pipe.send(std::span<const std::byte>(buf.data(), n));
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+    co_return total;
+}
+
+/**
+ * @brief A fixed set of epoll_reactors, each running on its own thread.
+ *
+ * The destructor stops all of the reactors and joins their threads. Coroutines that are
+ * still waiting on a reactor at that time are never resumed.
+ */
+class epoll_reactor_pool {
+    std::vector<std::unique_ptr<epoll_reactor>> _reactors;
+    std::vector<std::thread>                    _threads;
+    std::atomic<std::size_t>                    _next{0};
+
+public:
+    /**
+     * @brief Create and start the given number of reactors.
+     *
+     * @param n_threads The number of reactors. If zero, uses the number of hardware threads.
+     */
+    explicit epoll_reactor_pool(std::size_t n_threads = 0);
+    ~epoll_reactor_pool();
+
+    epoll_reactor_pool(const epoll_reactor_pool&)            = delete;
+    epoll_reactor_pool& operator=(const epoll_reactor_pool&) = delete;
+
+    /// The number of reactors in the pool
+    std::size_t size() const noexcept { return _reactors.size(); }
+
+    /// Obtain the reactor at the given index
+    epoll_reactor& operator[](std::size_t idx) noexcept { return *_reactors[idx]; }
+
+    /// Obtain a reactor from the pool, distributing work among them in round-robin order
+    epoll_reactor& next() noexcept {
+        return *_reactors[_next.fetch_add(1, std::memory_order_relaxed) % _reactors.size()];
+    }
+};
+
+}  // namespace neo
+
+#endif  // header check guard
@@ -0,0 +1,248 @@
+#include "./platform.hpp"
+
+#if NEO_OS_IS_LINUX
+
+#include "./epoll_reactor.hpp"
+
+#include "./channel.hpp"
+#include "./timer_wheel.hpp"
+#include "./when_all.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace {
+
+std::span<const std::byte> as_bytes(std::string_view s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+/// A non-blocking TCP socket listening on an ephemeral loopback port
+struct listener {
+    int           fd = -1;
+    ::sockaddr_in addr{};
+
+    listener() {
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        REQUIRE(fd >= 0);
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port        = 0;
+        REQUIRE(::bind(fd, reinterpret_cast<::sockaddr*>(&addr), sizeof addr) == 0);
+        ::socklen_t len = sizeof addr;
+        REQUIRE(::getsockname(fd, reinterpret_cast<::sockaddr*>(&addr), &len) == 0);
+        REQUIRE(::listen(fd, 64) == 0);
+    }
+
+    ~listener() { ::close(fd); }
+
+    const ::sockaddr* sockaddr() const noexcept {
+        return reinterpret_cast<const ::sockaddr*>(&addr);
+    }
+};
+
+int new_socket() { return ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0); }
+
+neo::task<std::string> recv_all(neo::epoll_reactor& r, int fd) {
+    std::string ret;
+    char        buf[7];
+    while (auto n = co_await r.recv(fd, std::as_writable_bytes(std::span(buf)))) {
+        ret.append(buf, n);
+    }
+    co_return ret;
+}
+
+neo::task<> echo_once(neo::epoll_reactor& r, int listen_fd) {
+    auto fd  = co_await r.accept(listen_fd);
+    auto msg = co_await recv_all(r, fd);
+    co_await r.send_all(fd, as_bytes(msg));
+    r.close(fd);
+}
+
+neo::task<std::string>
+echo_client(neo::epoll_reactor& r, const listener& l, std::string_view msg) {
+    auto fd = new_socket();
+    co_await r.connect(fd, l.sockaddr(), sizeof l.addr);
+    co_await r.send_all(fd, as_bytes(msg));
+    ::shutdown(fd, SHUT_WR);
+    auto got = co_await recv_all(r, fd);
+    r.close(fd);
+    co_return got;
+}
+
+}  // namespace
+
+TEST_CASE("Echo over a loopback socket") {
+    neo::epoll_reactor reactor;
+    listener           l;
+    std::string        big(100'000, 'x');
+    for (std::size_t i = 0; i < big.size(); ++i) {
+        big[i] = static_cast<char>('a' + i % 26);
+    }
+    auto [_, got]
+        = reactor.run(neo::when_all(echo_once(reactor, l.fd), echo_client(reactor, l, big)));
+    CHECK(got == big);
+}
+
+TEST_CASE("Connecting to a closed port fails") {
+    neo::epoll_reactor reactor;
+    ::sockaddr_in      addr{};
+    {
+        // Grab an ephemeral port, then close it
+        listener l;
+        addr = l.addr;
+    }
+    auto fd       = new_socket();
+    auto addr_ptr = reinterpret_cast<::sockaddr*>(&addr);
+    CHECK_THROWS_AS(reactor.run(reactor.connect(fd, addr_ptr, sizeof addr)), std::system_error);
+    reactor.close(fd);
+}
+
+namespace {
+
+/// A channel stage that splits a byte stream into lines, and returns the lines
+neo::channel<void, std::span<const std::byte>, std::vector<std::string>> split_lines() {
+    std::vector<std::string> lines;
+    std::string              partial;
+    while (true) {
+        std::span<const std::byte> chunk = co_yield 0;
+        if (chunk.empty()) {
+            break;
+        }
+        for (auto b : chunk) {
+            auto c = static_cast<char>(b);
+            if (c == '\n') {
+                lines.push_back(std::move(partial));
+                partial.clear();
+            } else {
+                partial.push_back(c);
+            }
+        }
+    }
+    co_return lines;
+}
+
+}  // namespace
+
+TEST_CASE("Feed a channel from a socket") {
+    neo::epoll_reactor reactor;
+    listener           l;
+    auto               ch = split_lines();
+    auto               io = ch.open();
+
+    auto server = [&]() -> neo::task<std::size_t> {
+        auto fd = co_await reactor.accept(l.fd);
+        auto n  = co_await neo::recv_into_channel(reactor, fd, io, 5);
+        reactor.close(fd);
+        co_return n;
+    };
+    auto client = [&]() -> neo::task<> {
+        auto fd = new_socket();
+        co_await reactor.connect(fd, l.sockaddr(), sizeof l.addr);
+        co_await reactor.send_all(fd, as_bytes("first line\nsec"));
+        co_await reactor.send_all(fd, as_bytes("ond line\nthird line\n"));
+        reactor.close(fd);
+    };
+    auto [n, _] = reactor.run(neo::when_all(server(), client()));
+    CHECK(n == 34);
+    REQUIRE(io.done());
+    CHECK(io.return_value()
+          == std::vector<std::string>{"first line", "second line", "third line"});
+}
+
+TEST_CASE("Serve connections with a pool of reactors") {
+    neo::epoll_reactor_pool pool{3};
+    listener                l;
+    const int               n_clients = 20;
+    std::atomic<int>        n_handled{0};
+
+    auto handle = [&](neo::epoll_reactor& r, int fd) -> neo::task<> {
+        auto msg = co_await recv_all(r, fd);
+        co_await r.send_all(fd, as_bytes(msg + "!"));
+        r.close(fd);
+        n_handled.fetch_add(1);
+    };
+
+    // Accept connections on the first reactor, and hand them out to the others
+    auto acceptor = [&]() -> neo::task<> {
+        for (int i = 0; i < n_clients; ++i) {
+            auto  fd = co_await pool[0].accept(l.fd);
+            auto& r  = pool.next();
+            r.spawn(handle(r, fd));
+        }
+    };
+    pool[0].spawn(acceptor());
+
+    // Connect with plain blocking sockets from this thread
+    for (int i = 0; i < n_clients; ++i) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(::connect(fd, l.sockaddr(), sizeof l.addr) == 0);
+        auto msg = "client " + std::to_string(i);
+        REQUIRE(::send(fd, msg.data(), msg.size(), 0) == static_cast<ssize_t>(msg.size()));
+        ::shutdown(fd, SHUT_WR);
+        std::string got;
+        char        buf[64];
+        while (auto n = ::recv(fd, buf, sizeof buf, 0)) {
+            REQUIRE(n > 0);
+            got.append(buf, static_cast<std::size_t>(n));
+        }
+        CHECK(got == msg + "!");
+        ::close(fd);
+    }
+    // Wait for the handlers to finish before stopping the pool
+    while (n_handled.load() != n_clients) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+TEST_CASE("Idle timeout on a socket") {
+    neo::epoll_reactor reactor;
+    neo::timer_wheel   wheel{std::chrono::milliseconds(1)};
+    int                fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) == 0);
+
+    bool timed_out = false;
+    bool done      = false;
+    auto reader    = [&]() -> neo::task<> {
+        std::byte buf[16];
+        // The peer never sends anything
+        auto n = co_await wheel.with_deadline(reactor.recv(fds[0], buf),
+                                              wheel.now() + std::chrono::milliseconds(20));
+        timed_out = not n.has_value();
+        // Abandon the receive, which is still waiting on the socket
+        reactor.cancel(fds[0]);
+        reactor.close(fds[0]);
+        done = true;
+    };
+    reactor.spawn(reader());
+    while (not done) {
+        auto next    = wheel.next_expiry();
+        int  timeout = -1;
+        if (next) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                *next - neo::timer_wheel::clock::now());
+            timeout = static_cast<int>(std::max(left.count(), std::int64_t(0)));
+        }
+        reactor.run_one(timeout);
+        wheel.advance(neo::timer_wheel::clock::now());
+    }
+    CHECK(timed_out);
+    CHECK(wheel.size() == 0);
+    ::close(fds[1]);
+}
+
+#endif  // NEO_OS_IS_LINUX
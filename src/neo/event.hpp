@@ -1,18 +1,52 @@
 #pragma once
 
 #include "./assert.hpp"
+#include "./config-pp.hpp"
+#include "./config.hpp"
 #include "./function_traits.hpp"
 #include "./fwd.hpp"
 #include "./invoke.hpp"
 #include "./optional.hpp"
+#include "./platform.hpp"
 #include "./scope.hpp"
 #include "./tag.hpp"
 #include "./type_traits.hpp"
 
 #include <tuple>
 
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+#include "./event_stats.hpp"
+#endif
+
 namespace neo {
 
+namespace event_detail {
+
+/*
+ * The feature changes the definitions of emit() and of the listeners, so it must be the same in
+ * every translation unit of a program. As with CoroFrameStats (see frame_alloc.hpp), each
+ * translation unit refers to the symbol for its own setting, and the library defines only the
+ * one that matches its build.
+ */
+extern const int event_stats_enabled;
+extern const int event_stats_disabled;
+
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+#if NEO_COMPILER(MSVC)
+#pragma detect_mismatch("neo_EventStats", "Enabled")
+#elif NEO_COMPILER(GNU, Clang)
+[[gnu::used]] static const int* const event_stats_mode = &event_stats_enabled;
+#endif
+#else
+#if NEO_COMPILER(MSVC)
+#pragma detect_mismatch("neo_EventStats", "Disabled")
+#elif NEO_COMPILER(GNU, Clang)
+[[gnu::used]] static const int* const event_stats_mode = &event_stats_disabled;
+#endif
+#endif
+
+}  // namespace event_detail
+
 /**
  * @brief Abstract class type that refers to an event subscription for event type T
  *
@@ -71,9 +105,9 @@ struct emit_result<T> {
 /// private
 class subscr_agent {
 public:
-    template <typename S, typename Ev>
+    template <bool Breadcrumbs = true, typename S, typename Ev>
     static decltype(auto) invoke(S&& s, Ev&& e) {
-        return s.invoke(e);
+        return s.template invoke<Breadcrumbs>(e);
     }
 
     template <typename S, typename Ev>
@@ -123,6 +157,87 @@ emit_result_t<E> get_default_emit_result(const E& ev)
     return emit_result_t<E>();
 }
 
+namespace event_detail {
+
+/// Invoke an event handler, and convert its result to the result that the emitter expects
+template <typename Handler, typename Event>
+emit_result_t<Event> invoke_handler(Handler& handler, const Event& event) {
+    using emit_result         = emit_result_t<Event>;
+    using GivenHandlerRetType = neo::invoke_result_t<Handler&, const Event&>;
+    if constexpr (convertible_to<GivenHandlerRetType, emit_result>) {
+        if constexpr (neo_is_void(emit_result)) {
+            static_assert(neo_is_void(GivenHandlerRetType),
+                          "The handler for this event type should not return a value");
+        }
+        return NEO_INVOKE(handler, event);
+    } else if constexpr (neo_is_void(GivenHandlerRetType)) {
+        NEO_INVOKE(handler, event);
+        return neo::get_default_emit_result(event);
+    } else {
+        static_assert(neo_is_void(GivenHandlerRetType),
+                      "The event handler's return type cannot convert to the type that is "
+                      "expected by the event's emitter");
+    }
+}
+
+}  // namespace event_detail
+
+/**
+ * @brief Customization point that binds an event type to a handler at compile time.
+ *
+ * The primary template binds nothing. Specialize it to inherit from
+ * `neo::static_listener<Event, Handler>`, or use `NEO_STATIC_LISTEN()`.
+ */
+template <typename Event>
+struct static_event_binding {};
+
+/**
+ * @brief Determine whether the given event type is bound to a `neo::static_listener`
+ */
+template <typename Event>
+concept static_listener_bound = requires { typename static_event_binding<Event>::handler_type; };
+
+/**
+ * @brief A handler for an event type that is known at compile time.
+ *
+ * When an event type is bound to a static_listener, `neo::emit()` calls its handler directly:
+ * There is no virtual call, no lookup of the thread-local listener stack, and no assertion
+ * breadcrumb, and the handler can be inlined into the emitter. The handler receives every
+ * event of that type on every thread, and dynamic listeners cannot be installed for it.
+ * Event types that are not bound are dispatched through the thread-local listener stack as
+ * usual.
+ *
+ * A new `Handler` is default-constructed for each event, so it should be an empty type, such
+ * as a captureless lambda.
+ *
+ * The binding must be visible before the first emit of the event type in every translation
+ * unit.
+ *
+ * @tparam Event The event type to handle
+ * @tparam Handler A default-constructible invocable type that accepts a `const Event&`
+ */
+template <typename Event, typename Handler>
+    requires invocable<Handler&, const Event&> and default_initializable<Handler>
+struct static_listener {
+    using event_type   = Event;
+    using handler_type = Handler;
+
+    static emit_result_t<Event> invoke(const Event& ev) {
+        Handler h{};
+        return event_detail::invoke_handler(h, ev);
+    }
+};
+
+/**
+ * @brief Bind an event type to a handler at compile time. Must appear at namespace scope.
+ *
+ * @param Event The event type
+ * @param ... The type of the handler. See `neo::static_listener`.
+ */
+#define NEO_STATIC_LISTEN(Event, ...)                                                              \
+    template <>                                                                                    \
+    struct neo::static_event_binding<Event> : ::neo::static_listener<Event, __VA_ARGS__> {}
+
 /**
  * @brief Obtain a reference to the current listener for the given event type, or 'null' if no
  * one is listening
@@ -149,16 +264,29 @@ private:
 
     /**
      * @brief Actually execute the event handler
+     *
+     * @tparam Breadcrumbs If `false`, do not record an assertion breadcrumb for the handler
      */
+    template <bool Breadcrumbs = true>
     emit_result invoke(const T& v) {
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+        event_stats_detail::record_invocation<T>();
+#endif
         // Store the prior executing handler
         auto prev_handler = event_detail::tl_currently_running_handler<T>;
         // Announce that we are the current handler
         event_detail::tl_currently_running_handler<T> = *this;
         // When scope leaves, restore the prior executing handler
         neo_defer { event_detail::tl_currently_running_handler<T> = prev_handler; };
-        // Go!
-        neo_assertion_breadcrumbs("Executing event handler", *this);
+        if constexpr (Breadcrumbs) {
+            neo_assertion_breadcrumbs("Executing event handler", *this);
+            return _invoke_handler(v);
+        } else {
+            return _invoke_handler(v);
+        }
+    }
+
+    emit_result _invoke_handler(const T& v) {
         if constexpr (event_bubbles<T>) {
             static_assert(
                 neo_is_void(emit_result_t<T>),
@@ -226,26 +354,48 @@ private:
 
 namespace event_detail {
 
-/// Emit a single instance of the given event
-template <typename Event>
-decltype(auto) emit_one(const Event& ev) {
+/// Emit a single instance of the given event, optionally with an assertion breadcrumb
+template <bool Breadcrumbs, typename Event>
+decltype(auto) emit_one_impl(const Event& ev) {
     using emit_type = emit_as_t<Event>;
-    auto& handler   = event_detail::tl_tail_listener<emit_type>;
     static_assert(
         convertible_to<const Event&, const emit_type&>,
         "The event type defines an emit_as alias, but the event object cannot bind to a reference "
         "to that type. Check that the emit_as alias is an accessible base class of the event type "
         "or that the appropriate conversion operator is defined.");
     const emit_type& downcast_event = ev;
-    if (handler) {
-        return subscr_agent::invoke(*handler, downcast_event);
+    if constexpr (static_listener_bound<emit_type>) {
+        // The handler is known statically. Skip the listener stack.
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+        event_stats_detail::emit_recorder<emit_type> rec;
+        event_stats_detail::record_invocation<emit_type>();
+#endif
+        return static_event_binding<emit_type>::invoke(downcast_event);
     } else {
-        if constexpr (not neo_is_void(emit_result_t<emit_type>)) {
-            return neo::get_default_emit_result(downcast_event);
+        auto& handler = event_detail::tl_tail_listener<emit_type>;
+        if (handler) {
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+            // Counts the handlers that the event bubbles through, and times them
+            event_stats_detail::emit_recorder<emit_type> rec;
+#endif
+            return subscr_agent::invoke<Breadcrumbs>(*handler, downcast_event);
+        } else {
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+            event_stats_detail::record_unhandled<emit_type>();
+#endif
+            if constexpr (not neo_is_void(emit_result_t<emit_type>)) {
+                return neo::get_default_emit_result(downcast_event);
+            }
         }
     }
 }
 
+/// Emit a single instance of the given event
+template <typename Event>
+decltype(auto) emit_one(const Event& ev) {
+    return emit_one_impl<true>(ev);
+}
+
 /// Emit a single event, but lazily call a factory function that will produce the event object
 template <typename EventReturner>
 void emit_one(const EventReturner& func)
@@ -254,7 +404,8 @@ void emit_one(const EventReturner& func)
     // The actual event type:
     using EventType = emit_as_t<neo::invoke_result_t<EventReturner>>;
     // If we have a handler, invoke the factory and emit the event
-    if (!!event_detail::tl_tail_listener<remove_cvref_t<EventType>>) {
+    if (static_listener_bound<remove_cvref_t<EventType>>
+        or !!event_detail::tl_tail_listener<remove_cvref_t<EventType>>) {
         emit_one(NEO_INVOKE(func));
     }
 }
@@ -294,22 +445,12 @@ class listener : scoped_listener<ListenEvent> {
 
     using typename listener::scoped_listener::emit_result;
 
+    static_assert(not static_listener_bound<ListenEvent>,
+                  "This event type is bound to a neo::static_listener, which receives every "
+                  "emitted event. A dynamic listener for it would never be invoked.");
+
     emit_result do_invoke(const ListenEvent& event) const override {
-        using GivenHandlerRetType = neo::invoke_result_t<Handler&, const ListenEvent&>;
-        if constexpr (convertible_to<GivenHandlerRetType, emit_result>) {
-            if constexpr (neo_is_void(emit_result)) {
-                static_assert(neo_is_void(GivenHandlerRetType),
-                              "The handler for this event type should not return a value");
-            }
-            return NEO_INVOKE(_handler, event);
-        } else if constexpr (neo_is_void(GivenHandlerRetType)) {
-            NEO_INVOKE(_handler, event);
-            return neo::get_default_emit_result(event);
-        } else {
-            static_assert(neo_is_void(GivenHandlerRetType),
-                          "The event handler's return type cannot convert to the type that is "
-                          "expected by the event's emitter");
-        }
+        return event_detail::invoke_handler(_handler, event);
     }
 
 public:
@@ -405,6 +546,17 @@ decltype(auto) emit(const Events&... ev) {
     }
 }
 
+/**
+ * @brief Emit a single event to the thread-local listener, without recording an
+ * assertion breadcrumb for the handler.
+ *
+ * Otherwise equivalent to `emit(ev)` with a single event object.
+ */
+template <typename Event>
+decltype(auto) emit_fast(const Event& ev) {
+    return event_detail::emit_one_impl<false>(ev);
+}
+
 /**
  * @brief Re-emit the given event to the parent handler in the event-handler
  * chain.
@@ -419,14 +571,21 @@ decltype(auto) emit(const Events&... ev) {
  */
 template <typename Event>
 decltype(auto) bubble_event(const Event& ev) {
-    auto cur_handler = event_detail::tl_currently_running_handler<Event>;
-    neo_assert(expects,
-               !!cur_handler,
-               "bubble_event() must only be called during the execution of an event handler of the "
-               "same type");
     static_assert(!event_bubbles<Event>,
                   "bubble_event() should not be called for an event that bubbles by default");
-    return event_detail::subscr_agent::bubble_event(*cur_handler, ev);
+    if constexpr (static_listener_bound<Event>) {
+        // A static listener has no parent handler
+        if constexpr (not neo_is_void(emit_result_t<Event>)) {
+            return neo::get_default_emit_result(ev);
+        }
+    } else {
+        auto cur_handler = event_detail::tl_currently_running_handler<Event>;
+        neo_assert(expects,
+                   !!cur_handler,
+                   "bubble_event() must only be called during the execution of an event handler of "
+                   "the same type");
+        return event_detail::subscr_agent::bubble_event(*cur_handler, ev);
+    }
 }
 
 /**
@@ -511,6 +670,9 @@ using opt_subscription [[deprecated("Use opt_listener<T>")]]
  */
 template <typename Event>
 [[nodiscard]] bool has_listener() noexcept {
+    if constexpr (static_listener_bound<Event>) {
+        return true;
+    }
     return !!event_detail::tl_tail_listener<Event>;
 }
 
@@ -534,9 +696,13 @@ public:
  */
 template <typename Event>
 void cancel_bubbling(const Event&) noexcept {
-    auto cur_handler = event_detail::tl_currently_running_handler<Event>;
     static_assert(event_bubbles<Event>,
                   "cancel_bubbling() should only be called for events that bubble by default");
+    if constexpr (static_listener_bound<Event>) {
+        // A static listener has no parent handler to bubble to
+        return;
+    }
+    auto cur_handler = event_detail::tl_currently_running_handler<Event>;
     neo_assert(expects,
                !!cur_handler,
                "cancel_bubbling() must only be called during the execution of an event handler of "
@@ -3,6 +3,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
 using neo::repr_ostream_operator::operator<<;
 
 struct my_event {
@@ -201,3 +205,111 @@ TEST_CASE("Events that want a return type") {
         CHECK(neo::emit(event_with_return{}) == 91);
     }
 }
+
+namespace {
+
+struct static_event {
+    int value;
+};
+
+struct static_result_event {
+    using emit_result = int;
+    int value;
+};
+
+struct static_bubbling_event {
+    constexpr static bool event_bubbles = true;
+    int                   value;
+};
+
+struct derived_static_event : static_event {
+    using emit_as = static_event;
+};
+
+struct dynamic_counted_event {
+    int value;
+};
+
+int static_event_total = 0;
+
+struct static_event_handler {
+    void operator()(const static_event& ev) const noexcept { static_event_total += ev.value; }
+};
+
+}  // namespace
+
+NEO_STATIC_LISTEN(static_event, static_event_handler);
+NEO_STATIC_LISTEN(static_result_event, decltype([](const static_result_event& ev) {
+                      return ev.value * 2;
+                  }));
+
+namespace {
+
+// Handlers that bubble must be defined after the event type is bound
+struct static_bubbling_handler {
+    void operator()(const static_bubbling_event& ev) const noexcept;
+};
+
+}  // namespace
+
+NEO_STATIC_LISTEN(static_bubbling_event, static_bubbling_handler);
+
+void static_bubbling_handler::operator()(const static_bubbling_event& ev) const noexcept {
+    // There is no parent handler, so these do nothing
+    neo::cancel_bubbling(ev);
+    neo::bubble_event(static_event{ev.value});
+    static_event_total = ev.value;
+}
+
+TEST_CASE("Statically bound listeners") {
+    static_assert(neo::static_listener_bound<static_event>);
+    static_assert(not neo::static_listener_bound<dynamic_counted_event>);
+    CHECK(neo::has_listener<static_event>());
+
+    static_event_total = 0;
+    neo::emit(static_event{2}, static_event{3});
+    CHECK(static_event_total == 5);
+    neo::emit_fast(static_event{4});
+    CHECK(static_event_total == 9);
+    // Dispatched by its emit_as type
+    neo::emit(derived_static_event{{10}});
+    CHECK(static_event_total == 19);
+    // Event factories are always called
+    NEO_EMIT(static_event{1});
+    CHECK(static_event_total == 20);
+
+    // The handler receives events on every thread
+    std::thread([] { neo::emit(static_event{100}); }).join();
+    CHECK(static_event_total == 120);
+
+    CHECK(neo::emit(static_result_event{21}) == 42);
+
+    neo::emit(static_bubbling_event{7});
+    CHECK(static_event_total == 7);
+}
+
+TEST_CASE("Static listener benchmark", "[.][benchmark]") {
+    const int n        = 10'000'000;
+    static_event_total = 0;
+    int dynamic_total  = 0;
+    NEO_LISTEN(const dynamic_counted_event& ev) { dynamic_total += ev.value; };
+
+    auto time_per_event = [&](auto emit_one) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) {
+            emit_one();
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(dur).count() / n;
+    };
+    auto static_ns  = time_per_event([] { neo::emit(static_event{1}); });
+    auto dynamic_ns = time_per_event([] { neo::emit(dynamic_counted_event{1}); });
+    auto fast_ns    = time_per_event([] { neo::emit_fast(dynamic_counted_event{1}); });
+    CHECK(static_event_total == n);
+    CHECK(dynamic_total == 2 * n);
+    std::printf("static: %5.2f ns, dynamic: %5.2f ns, dynamic without breadcrumbs: %5.2f ns per "
+                "event\n",
+                static_ns,
+                dynamic_ns,
+                fast_ns);
+}
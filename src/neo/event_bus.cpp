@@ -0,0 +1,75 @@
+#include "./event_bus.hpp"
+
+#include <thread>
+
+using namespace neo;
+using event_bus_detail::rcu_reader;
+
+namespace {
+
+/// The list of the readers of all live threads
+struct reader_registry {
+    std::mutex  mtx;
+    rcu_reader* head = nullptr;
+
+    void add(rcu_reader& r) noexcept {
+        std::scoped_lock lk{mtx};
+        r.next = head;
+        if (head) {
+            head->prev = &r;
+        }
+        head = &r;
+    }
+
+    void remove(rcu_reader& r) noexcept {
+        std::scoped_lock lk{mtx};
+        if (r.prev) {
+            r.prev->next = r.next;
+        } else {
+            head = r.next;
+        }
+        if (r.next) {
+            r.next->prev = r.prev;
+        }
+    }
+};
+
+reader_registry& registry() noexcept {
+    // Leaked so that threads exiting during static destruction can still unregister
+    static auto inst = new reader_registry;
+    return *inst;
+}
+
+/// Registers the thread's reader for the lifetime of the thread
+struct thread_reader : rcu_reader {
+    thread_reader() noexcept { registry().add(*this); }
+    ~thread_reader() { registry().remove(*this); }
+};
+
+thread_local thread_reader tl_reader;
+
+}  // namespace
+
+rcu_reader& event_bus_detail::this_thread_reader() noexcept { return tl_reader; }
+
+void event_bus_detail::rcu_synchronize() noexcept {
+    neo_assert(expects,
+               this_thread_reader().nesting == 0,
+               "An event_bus listener was added or removed while an event_bus handler was "
+               "executing on the same thread");
+    auto& reg = registry();
+    // Hold the registry lock to keep readers from unregistering while we scan them
+    std::scoped_lock lk{reg.mtx};
+    const auto       new_epoch = rcu_global_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (auto r = reg.head; r; r = r->next) {
+        // Wait for the reader to leave any critical section that it began before the new epoch
+        while (true) {
+            auto e = r->epoch.load(std::memory_order_acquire);
+            if (e == 0 or e >= new_epoch) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
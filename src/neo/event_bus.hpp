@@ -0,0 +1,262 @@
+#pragma once
+
+#include "./assert.hpp"
+#include "./fwd.hpp"
+#include "./invoke.hpp"
+#include "./type_traits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace neo {
+
+namespace event_bus_detail {
+
+/**
+ * @brief Read-side state of a thread that emits events on an event_bus.
+ *
+ * Each thread has its own reader, so entering and leaving a read-side critical section
+ * only touches memory that is owned by the calling thread.
+ */
+struct rcu_reader {
+    /// Zero if the thread is not within a read-side critical section. Otherwise, the value of
+    /// the global epoch when the outermost critical section was entered.
+    alignas(64) std::atomic<std::uint64_t> epoch{0};
+    /// The depth of nested critical sections. Only accessed by the owning thread.
+    unsigned nesting = 0;
+
+    // Intrusive links in the list of all readers
+    rcu_reader* next = nullptr;
+    rcu_reader* prev = nullptr;
+};
+
+/// The global grace-period epoch. Starts at one, since zero denotes a quiescent reader.
+inline std::atomic<std::uint64_t> rcu_global_epoch{1};
+
+/// Obtain the reader for the calling thread. Registers the thread on first use.
+rcu_reader& this_thread_reader() noexcept;
+
+/**
+ * @brief Block until every read-side critical section that was active at the time of the call
+ * has been exited.
+ *
+ * @pre Must not be called from within a read-side critical section.
+ */
+void rcu_synchronize() noexcept;
+
+/**
+ * @brief A read-side critical section. While any guard is alive, listener arrays that
+ * were loaded by the calling thread will not be freed.
+ */
+class rcu_read_guard {
+    rcu_reader& _reader;
+
+public:
+    rcu_read_guard() noexcept
+        : _reader(this_thread_reader()) {
+        if (_reader.nesting++ == 0) {
+            _reader.epoch.store(rcu_global_epoch.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+            // Publish our epoch before we load any protected pointers
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    ~rcu_read_guard() {
+        if (--_reader.nesting == 0) {
+            _reader.epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    rcu_read_guard(const rcu_read_guard&) = delete;
+};
+
+}  // namespace event_bus_detail
+
+template <typename Event, typename Handler>
+class bus_listener;
+
+/**
+ * @brief A process-wide broadcast channel for events of type `Event`.
+ *
+ * Unlike `neo::emit()`, which dispatches to a thread-local stack of listeners, an event_bus
+ * delivers each emitted event to every listener that is attached to the bus, regardless of
+ * the thread that attached it. Handlers are run on the emitting thread.
+ *
+ * Emitting takes no locks: The set of listeners is an immutable array that is replaced
+ * whenever a listener is added or removed, and old arrays are reclaimed using an RCU-style
+ * grace period. Adding and removing listeners is comparatively expensive, as it must wait for
+ * all in-progress emits to finish.
+ *
+ * A handler must not remove its own listener from the bus that is executing it.
+ *
+ * @tparam Event The type of event that is broadcast
+ */
+template <typename Event>
+class event_bus {
+    // A listener attached to the bus
+    struct entry {
+        void* ctx;
+        void (*invoke)(void* ctx, const Event&);
+    };
+
+    // An immutable array of listeners
+    struct listener_array {
+        std::size_t              size = 0;
+        std::unique_ptr<entry[]> entries;
+    };
+
+    std::atomic<const listener_array*> _listeners{nullptr};
+    // Serializes updates to the listener array
+    std::mutex _update_mtx;
+
+    template <typename, typename>
+    friend class bus_listener;
+
+    // Publish a new array, then free the old one once no thread can be reading it.
+    void _replace(std::unique_ptr<listener_array> arr) noexcept {
+        auto old = _listeners.exchange(arr.release(), std::memory_order_acq_rel);
+        event_bus_detail::rcu_synchronize();
+        delete old;
+    }
+
+    void _add(entry e) {
+        std::scoped_lock lk{_update_mtx};
+        auto             cur = _listeners.load(std::memory_order_relaxed);
+        auto             arr = std::make_unique<listener_array>();
+        arr->size            = (cur ? cur->size : 0) + 1;
+        arr->entries         = std::make_unique<entry[]>(arr->size);
+        if (cur) {
+            std::copy_n(cur->entries.get(), cur->size, arr->entries.get());
+        }
+        arr->entries[arr->size - 1] = e;
+        _replace(NEO_MOVE(arr));
+    }
+
+    void _remove(void* ctx) noexcept {
+        std::scoped_lock lk{_update_mtx};
+        auto             cur = _listeners.load(std::memory_order_relaxed);
+        neo_assert(invariant, cur != nullptr, "Removing a listener from an empty event_bus", ctx);
+        std::unique_ptr<listener_array> arr;
+        if (cur->size > 1) {
+            arr          = std::make_unique<listener_array>();
+            arr->size    = cur->size - 1;
+            arr->entries = std::make_unique<entry[]>(arr->size);
+            std::remove_copy_if(cur->entries.get(),
+                                cur->entries.get() + cur->size,
+                                arr->entries.get(),
+                                [&](const entry& e) { return e.ctx == ctx; });
+        }
+        _replace(NEO_MOVE(arr));
+    }
+
+    template <bool Breadcrumbs>
+    void _emit(const Event& ev) const {
+        event_bus_detail::rcu_read_guard guard;
+        auto arr = _listeners.load(std::memory_order_acquire);
+        if (arr == nullptr) {
+            return;
+        }
+        for (auto it = arr->entries.get(), stop = it + arr->size; it != stop; ++it) {
+            if constexpr (Breadcrumbs) {
+                neo_assertion_breadcrumbs("Executing event_bus handler", ev);
+                it->invoke(it->ctx, ev);
+            } else {
+                it->invoke(it->ctx, ev);
+            }
+        }
+    }
+
+public:
+    event_bus() = default;
+
+    ~event_bus() {
+        auto arr = _listeners.load(std::memory_order_acquire);
+        neo_assert(expects,
+                   arr == nullptr,
+                   "An event_bus was destroyed while listeners were still attached",
+                   arr);
+    }
+
+    event_bus(const event_bus&) = delete;
+
+    /**
+     * @brief Obtain the process-wide event_bus for the `Event` type.
+     */
+    static event_bus& global() noexcept {
+        static event_bus inst;
+        return inst;
+    }
+
+    /**
+     * @brief Deliver the event to every listener that is attached to the bus.
+     *
+     * Each handler is executed with an assertion breadcrumb of the event.
+     */
+    void emit(const Event& ev) const { _emit<true>(ev); }
+
+    /**
+     * @brief Deliver the event to every listener that is attached to the bus, without
+     * recording assertion breadcrumbs.
+     */
+    void emit_fast(const Event& ev) const { _emit<false>(ev); }
+
+    /// Determine whether any listeners are attached to the bus
+    [[nodiscard]] bool has_listeners() const noexcept {
+        return _listeners.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /// Get the number of listeners that are attached to the bus
+    [[nodiscard]] std::size_t listener_count() const noexcept {
+        event_bus_detail::rcu_read_guard guard;
+        auto                             arr = _listeners.load(std::memory_order_acquire);
+        return arr ? arr->size : 0;
+    }
+
+    /**
+     * @brief Attach the given handler to the bus. The handler is detached when the returned
+     * object is destroyed.
+     */
+    template <typename Handler>
+        requires invocable<Handler&, const Event&>
+    [[nodiscard]] bus_listener<Event, remove_cvref_t<Handler>> listen(Handler&& h) {
+        return bus_listener<Event, remove_cvref_t<Handler>>(*this, NEO_FWD(h));
+    }
+};
+
+/**
+ * @brief Keeps a handler attached to an event_bus for the duration of its lifetime.
+ *
+ * Usually obtained using `event_bus::listen()`.
+ */
+template <typename Event, typename Handler>
+class [[nodiscard]] bus_listener {
+    event_bus<Event>&     _bus;
+    NEO_NO_UNIQUE_ADDRESS Handler _handler;
+
+    friend event_bus<Event>;
+
+    static void _invoke(void* ctx, const Event& ev) {
+        NEO_INVOKE(static_cast<bus_listener*>(ctx)->_handler, ev);
+    }
+
+public:
+    /// Attach the given handler to the given bus
+    template <typename H>
+    bus_listener(event_bus<Event>& bus, H&& h)
+        : _bus(bus)
+        , _handler(NEO_FWD(h)) {
+        _bus._add({this, &_invoke});
+    }
+
+    ~bus_listener() { _bus._remove(this); }
+
+    // We are immobile
+    bus_listener(const bus_listener&) = delete;
+};
+
+}  // namespace neo
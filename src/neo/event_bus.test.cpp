@@ -0,0 +1,93 @@
+#include "./event_bus.hpp"
+
+#include "./event.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct ev_count {
+    int value;
+};
+
+}  // namespace
+
+TEST_CASE("Broadcast to several listeners") {
+    neo::event_bus<ev_count> bus;
+    CHECK_FALSE(bus.has_listeners());
+    bus.emit(ev_count{1});  // No one is listening
+
+    int a = 0;
+    int b = 0;
+    {
+        auto l1 = bus.listen([&](const ev_count& ev) { a += ev.value; });
+        CHECK(bus.listener_count() == 1);
+        bus.emit(ev_count{2});
+        CHECK(a == 2);
+        {
+            auto l2 = bus.listen([&](const ev_count& ev) { b += ev.value; });
+            CHECK(bus.listener_count() == 2);
+            bus.emit(ev_count{3});
+            bus.emit_fast(ev_count{4});
+            CHECK(a == 9);
+            CHECK(b == 7);
+        }
+        CHECK(bus.listener_count() == 1);
+        bus.emit(ev_count{5});
+        CHECK(a == 14);
+        CHECK(b == 7);
+    }
+    CHECK_FALSE(bus.has_listeners());
+}
+
+TEST_CASE("Remove a listener from the middle") {
+    neo::event_bus<ev_count> bus;
+    std::vector<int>         got;
+    auto l1 = bus.listen([&](const ev_count&) { got.push_back(1); });
+    std::optional<neo::bus_listener<ev_count, std::function<void(const ev_count&)>>> l2;
+    l2.emplace(bus, [&](const ev_count&) { got.push_back(2); });
+    auto l3 = bus.listen([&](const ev_count&) { got.push_back(3); });
+    bus.emit(ev_count{0});
+    CHECK(got == std::vector<int>{1, 2, 3});
+    got.clear();
+    l2.reset();
+    bus.emit(ev_count{0});
+    CHECK(got == std::vector<int>{1, 3});
+}
+
+TEST_CASE("Emit events across threads") {
+    auto&            bus = neo::event_bus<ev_count>::global();
+    std::atomic<int> total{0};
+    auto             l = bus.listen([&](const ev_count& ev) { total += ev.value; });
+
+    std::vector<std::thread> emitters;
+    for (int i = 0; i < 4; ++i) {
+        emitters.emplace_back([&] {
+            for (int n = 0; n < 1000; ++n) {
+                bus.emit_fast(ev_count{1});
+            }
+        });
+    }
+    // Churn the listener set while other threads are emitting
+    std::atomic<int> churn{0};
+    for (int i = 0; i < 50; ++i) {
+        auto tmp = bus.listen([&](const ev_count&) { ++churn; });
+    }
+    for (auto& t : emitters) {
+        t.join();
+    }
+    CHECK(total == 4000);
+}
+
+TEST_CASE("Fast thread-local emit") {
+    int  got = 0;
+    auto l   = neo::listen([&](const ev_count& ev) { got = ev.value; });
+    neo::emit_fast(ev_count{42});
+    CHECK(got == 42);
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "./assert.hpp"
+#include "./event.hpp"
+#include "./fwd.hpp"
+#include "./scope.hpp"
+#include "./type_traits.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace neo {
+
+namespace event_queue_detail {
+
+/// Assigns a small dense index to each event type that is queued anywhere in the program
+inline std::atomic<std::size_t> next_type_index{0};
+
+template <typename Event>
+inline const std::size_t type_index = next_type_index.fetch_add(1, std::memory_order_relaxed);
+
+/// The buffer of queued events of a single type
+struct segment_base {
+    /// The next segment with pending events, in order of their first pending event
+    segment_base* next_pending = nullptr;
+    bool          is_pending   = false;
+
+    virtual ~segment_base() = default;
+    /// Dispatch the pending events. Returns the number of events that were dispatched.
+    virtual std::size_t dispatch() = 0;
+    virtual std::size_t size() const noexcept = 0;
+    virtual void        clear() noexcept      = 0;
+};
+
+template <typename Event>
+struct segment final : segment_base {
+    std::vector<Event> pending;
+    // The batch that is being dispatched. Handlers may queue more events while it is being
+    // dispatched, which go to `pending`. Both buffers keep their capacity.
+    std::vector<Event> dispatching;
+
+    std::size_t dispatch() override {
+        dispatching.swap(pending);
+        neo_defer { dispatching.clear(); };
+        const auto n = dispatching.size();
+        // Only look for a listener once per batch
+        if (not has_listener<emit_as_t<Event>>()) {
+            return n;
+        }
+        for (const Event& ev : dispatching) {
+            event_detail::emit_one_impl<true>(ev);
+        }
+        return n;
+    }
+
+    std::size_t size() const noexcept override { return pending.size(); }
+    void        clear() noexcept override { pending.clear(); }
+};
+
+}  // namespace event_queue_detail
+
+/**
+ * @brief Captures emitted events in a buffer, to be dispatched later in batches with
+ * `drain()`.
+ *
+ * `neo::emit()` runs the handler for an event right away, inside of the emitter. With an
+ * event_queue, the emitter only pays for appending a copy of the event to a buffer, and
+ * the handlers run when the owner of the queue calls `drain()`, e.g. at the end of a request
+ * or when the thread is idle.
+ *
+ * Events are kept in a separate buffer for each event type. The buffers keep their capacity
+ * when they are drained, so a queue does not allocate in the steady state. `drain()`
+ * dispatches the events of one type at a time, as a batch, in the order in which each type
+ * was first queued, so events of the *same* type are dispatched in order, but events of
+ * different types may be reordered.
+ *
+ * The events are dispatched through the listeners that are in scope on the thread that calls
+ * `drain()`, exactly as if they were passed to `neo::emit()` at that point. The results of
+ * events that have an `emit_result` are discarded. Events whose type has no listener at the
+ * time of the drain are dropped.
+ *
+ * An event_queue is not thread-safe. Use `event_queue::this_thread()` for a queue that
+ * belongs to the current thread, which is what `neo::emit_deferred()` uses.
+ */
+class event_queue {
+    // Indexed by event_queue_detail::type_index
+    std::vector<std::unique_ptr<event_queue_detail::segment_base>> _segments;
+
+    event_queue_detail::segment_base* _pending_head = nullptr;
+    event_queue_detail::segment_base* _pending_tail = nullptr;
+    bool                              _draining     = false;
+
+    template <typename Event>
+    event_queue_detail::segment<Event>& _segment() {
+        const auto idx = event_queue_detail::type_index<Event>;
+        if (idx >= _segments.size()) [[unlikely]] {
+            _segments.resize(idx + 1);
+        }
+        auto& seg = _segments[idx];
+        if (not seg) [[unlikely]] {
+            seg = std::make_unique<event_queue_detail::segment<Event>>();
+        }
+        return static_cast<event_queue_detail::segment<Event>&>(*seg);
+    }
+
+    void _mark_pending(event_queue_detail::segment_base& seg) noexcept {
+        if (seg.is_pending) {
+            return;
+        }
+        seg.is_pending   = true;
+        seg.next_pending = nullptr;
+        if (_pending_tail) {
+            _pending_tail->next_pending = &seg;
+        } else {
+            _pending_head = &seg;
+        }
+        _pending_tail = &seg;
+    }
+
+    event_queue_detail::segment_base* _pop_pending() noexcept {
+        auto seg = _pending_head;
+        if (seg) {
+            _pending_head = seg->next_pending;
+            if (_pending_head == nullptr) {
+                _pending_tail = nullptr;
+            }
+            seg->is_pending = false;
+        }
+        return seg;
+    }
+
+public:
+    event_queue() = default;
+    // The list of pending segments points into the queue
+    event_queue(const event_queue&) = delete;
+
+    /// Get the event_queue that belongs to the calling thread
+    static event_queue& this_thread() noexcept {
+        thread_local event_queue q;
+        return q;
+    }
+
+    /**
+     * @brief Queue a copy of the given event, to be dispatched by `drain()`.
+     */
+    template <typename Event>
+    void emit(Event&& ev) {
+        auto& seg = _segment<remove_cvref_t<Event>>();
+        seg.pending.push_back(NEO_FWD(ev));
+        _mark_pending(seg);
+    }
+
+    /**
+     * @brief Dispatch every queued event to its listener.
+     *
+     * Events that are queued by handlers during the drain are dispatched as well. If a
+     * handler throws, the exception propagates, and the rest of the batch of events that it
+     * belonged to is dropped. Events of other types stay queued.
+     *
+     * Must not be called from within a handler that is being run by `drain()`.
+     *
+     * @return The number of events that were taken from the queue.
+     */
+    std::size_t drain() {
+        neo_assert(expects,
+                   not _draining,
+                   "event_queue::drain() was called from within an event handler that is being "
+                   "dispatched by the same event_queue");
+        _draining = true;
+        neo_defer { _draining = false; };
+        std::size_t n = 0;
+        while (auto seg = _pop_pending()) {
+            n += seg->dispatch();
+        }
+        return n;
+    }
+
+    /// The number of events that are waiting to be dispatched
+    [[nodiscard]] std::size_t size() const noexcept {
+        std::size_t n = 0;
+        for (auto seg = _pending_head; seg; seg = seg->next_pending) {
+            n += seg->size();
+        }
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return _pending_head == nullptr; }
+
+    /// Drop every queued event without dispatching them
+    void clear() noexcept {
+        while (auto seg = _pop_pending()) {
+            seg->clear();
+        }
+    }
+};
+
+/**
+ * @brief Queue one or more events on the calling thread's event_queue, to be dispatched by a
+ * later call to `neo::drain_events()`.
+ */
+template <typename... Events>
+void emit_deferred(Events&&... ev) {
+    auto& q = event_queue::this_thread();
+    (q.emit(NEO_FWD(ev)), ...);
+}
+
+/**
+ * @brief Dispatch the events that were queued with `neo::emit_deferred()` on the calling
+ * thread. See `event_queue::drain()`.
+ */
+inline std::size_t drain_events() { return event_queue::this_thread().drain(); }
+
+}  // namespace neo
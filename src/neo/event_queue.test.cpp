@@ -0,0 +1,150 @@
+#include "./event_queue.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ev_request {
+    int id;
+};
+
+struct ev_log {
+    std::string message;
+};
+
+struct ev_question {
+    using emit_result = int;
+};
+
+}  // namespace
+
+TEST_CASE("Deferred events are dispatched on drain") {
+    std::vector<int> ids;
+    NEO_LISTEN(ev_request ev) { ids.push_back(ev.id); };
+
+    neo::event_queue q;
+    CHECK(q.empty());
+    q.emit(ev_request{1});
+    q.emit(ev_request{2});
+    CHECK(ids.empty());
+    CHECK(q.size() == 2);
+    CHECK(q.drain() == 2);
+    CHECK(ids == std::vector<int>{1, 2});
+    CHECK(q.empty());
+    CHECK(q.drain() == 0);
+}
+
+TEST_CASE("Events are batched by type") {
+    std::vector<std::string> log;
+    NEO_LISTEN(ev_request ev) { log.push_back("req " + std::to_string(ev.id)); };
+    NEO_LISTEN(const ev_log& ev) { log.push_back(ev.message); };
+    NEO_LISTEN(ev_question) { return 42; };
+
+    neo::event_queue q;
+    q.emit(ev_log{"first"});
+    q.emit(ev_request{1});
+    q.emit(ev_log{"second"});
+    q.emit(ev_question{});
+    q.emit(ev_request{2});
+    CHECK(q.drain() == 5);
+    // Each type is dispatched in the order that it was first queued
+    CHECK(log == std::vector<std::string>{"first", "second", "req 1", "req 2"});
+}
+
+TEST_CASE("Listeners are found at the time of the drain") {
+    neo::event_queue q;
+    q.emit(ev_request{1});
+    int n_seen = 0;
+    {
+        NEO_LISTEN(ev_request) { ++n_seen; };
+        q.emit(ev_request{2});
+    }
+    // No listener, so the events are dropped
+    CHECK(q.drain() == 2);
+    CHECK(n_seen == 0);
+
+    q.emit(ev_request{3});
+    NEO_LISTEN(ev_request) { ++n_seen; };
+    q.drain();
+    CHECK(n_seen == 1);
+}
+
+TEST_CASE("Handlers may queue more events") {
+    neo::event_queue q;
+    std::vector<int> ids;
+    NEO_LISTEN(ev_request ev) {
+        ids.push_back(ev.id);
+        if (ev.id < 5) {
+            q.emit(ev_request{ev.id + 1});
+        }
+    };
+    q.emit(ev_request{1});
+    CHECK(q.drain() == 5);
+    CHECK(ids == std::vector<int>{1, 2, 3, 4, 5});
+}
+
+TEST_CASE("A throwing handler drops the rest of its batch") {
+    neo::event_queue q;
+    int              n_logged = 0;
+    NEO_LISTEN(ev_request ev) {
+        if (ev.id == 2) {
+            throw std::runtime_error("bad request");
+        }
+    };
+    NEO_LISTEN(ev_log) { ++n_logged; };
+    q.emit(ev_request{1});
+    q.emit(ev_log{"kept"});
+    q.emit(ev_request{2});
+    q.emit(ev_request{3});
+    CHECK_THROWS_AS(q.drain(), std::runtime_error);
+    CHECK(q.size() == 1);
+    q.drain();
+    CHECK(n_logged == 1);
+}
+
+TEST_CASE("Per-thread deferred emission") {
+    std::vector<std::string> messages;
+    NEO_LISTEN(ev_log ev) { messages.push_back(ev.message); };
+    neo::emit_deferred(ev_log{"a"}, ev_log{"b"});
+    CHECK(messages.empty());
+    CHECK(neo::drain_events() == 2);
+    CHECK(messages == std::vector<std::string>{"a", "b"});
+    neo::event_queue::this_thread().clear();
+}
+
+TEST_CASE("Deferred emission throughput", "[.][benchmark]") {
+    const int n     = 10'000'000;
+    long long total = 0;
+    NEO_LISTEN(ev_request ev) { total += ev.id; };
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        neo::emit(ev_request{i});
+    }
+    auto emit_dur = std::chrono::steady_clock::now() - start;
+
+    neo::event_queue q;
+    std::chrono::steady_clock::duration append_dur{};
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i += 1000) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int j = i; j < i + 1000; ++j) {
+            q.emit(ev_request{j});
+        }
+        append_dur += std::chrono::steady_clock::now() - t0;
+        q.drain();
+    }
+    auto deferred_dur = std::chrono::steady_clock::now() - start;
+    CHECK(total == 2 * ((long long)n * (n - 1) / 2));
+    auto ns = [&](auto d) { return std::chrono::duration<double, std::nano>(d).count() / n; };
+    std::printf("emit: %5.2f ns, deferred append: %5.2f ns, append+drain: %5.2f ns per event\n",
+                ns(emit_dur),
+                ns(append_dur),
+                ns(deferred_dur));
+}
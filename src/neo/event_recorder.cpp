@@ -0,0 +1,113 @@
+#include "./event_recorder.hpp"
+
+#include "./platform.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+using namespace neo;
+
+namespace {
+
+/// Identifies event log files, and the version of their format
+constexpr std::string_view file_magic = "neo-evl\x01";
+
+constexpr std::size_t record_header_len = 8 + 8 + 4;
+
+[[noreturn]] void throw_file_error(int err, const char* what, const std::filesystem::path& path) {
+    throw std::system_error(err, std::system_category(), what + (" [" + path.string() + "]"));
+}
+
+std::FILE* open_file(const std::filesystem::path& path, const char* mode) {
+#if NEO_OS_IS_WINDOWS
+    // Native paths are wide strings on Windows
+    const std::wstring wide_mode(mode, mode + std::strlen(mode));
+    auto               f = ::_wfopen(path.c_str(), wide_mode.c_str());
+#else
+    auto f = std::fopen(path.c_str(), mode);
+#endif
+    if (f == nullptr) {
+        throw_file_error(errno, "Failed to open event log file", path);
+    }
+    return f;
+}
+
+}  // namespace
+
+event_log_writer::event_log_writer(const std::filesystem::path& path)
+    : _file(open_file(path, "wb")) {
+    _buffer.reserve(buffer_size + buffer_size / 4);
+    _buffer.append(file_magic);
+}
+
+event_log_writer::~event_log_writer() {
+    // Errors cannot be reported from here. Call flush() to see them.
+    std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+    std::fclose(_file);
+}
+
+void event_log_writer::flush() {
+    const auto n = std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+    if (n != _buffer.size() or std::fflush(_file) != 0) {
+        throw std::system_error(errno, std::system_category(), "Failed to write event log");
+    }
+    _buffer.clear();
+}
+
+event_log_reader::event_log_reader(const std::filesystem::path& path)
+    : _file(open_file(path, "rb")) {
+    // The destructor does not run if we throw, so close the file on the way out
+    bool is_log = false;
+    try {
+        is_log = _fill(file_magic.size())
+            and std::string_view(_buffer).substr(0, file_magic.size()) == file_magic;
+    } catch (...) {
+        std::fclose(_file);
+        throw;
+    }
+    if (not is_log) {
+        std::fclose(_file);
+        throw_file_error(EINVAL, "File is not an event log", path);
+    }
+    _pos = file_magic.size();
+}
+
+event_log_reader::~event_log_reader() { std::fclose(_file); }
+
+bool event_log_reader::_fill(std::size_t n) {
+    if (_buffer.size() - _pos >= n) {
+        return true;
+    }
+    // Drop the records that have been read, and read at least enough for `n` more bytes
+    _buffer.erase(0, _pos);
+    _pos            = 0;
+    const auto have = _buffer.size();
+    const auto want = std::max(n, std::size_t(event_log_writer::buffer_size));
+    _buffer.resize(have + want);
+    const auto got = std::fread(_buffer.data() + have, 1, want, _file);
+    _buffer.resize(have + got);
+    if (got < want and std::ferror(_file)) {
+        throw std::system_error(errno, std::system_category(), "Failed to read event log");
+    }
+    return _buffer.size() >= n;
+}
+
+std::optional<event_log_record> event_log_reader::next() {
+    if (not _fill(record_header_len)) {
+        return std::nullopt;
+    }
+    event_log_record rec;
+    std::uint32_t    size = 0;
+    auto             p    = _buffer.data() + _pos;
+    std::memcpy(&rec.time_ns, p, sizeof rec.time_ns);
+    std::memcpy(&rec.tag, p + 8, sizeof rec.tag);
+    std::memcpy(&size, p + 16, sizeof size);
+    if (not _fill(record_header_len + size)) {
+        return std::nullopt;
+    }
+    rec.payload = std::string_view(_buffer).substr(_pos + record_header_len, size);
+    _pos += record_header_len + size;
+    return rec;
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "./assert.hpp"
+#include "./event.hpp"
+#include "./type_name.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace neo {
+
+/**
+ * @brief Customization point that converts events to and from the bytes of an event log.
+ *
+ * The primary template copies the object representation of trivially copyable events. Such
+ * events must not hold pointers or references, which would not be valid when they are
+ * replayed. Specialize it for other event types, with:
+ *
+ * - `static void encode(const Event&, std::string& out)`, which appends the bytes of the event
+ *   to `out`, and
+ * - `static Event decode(std::string_view bytes)`, which reconstructs an event from the bytes
+ *   that `encode()` produced.
+ *
+ * A specialization may also define `static constexpr std::string_view name`, which identifies
+ * the event type in the log. It defaults to `neo::type_name<Event>()`. Give event types an
+ * explicit name if logs are to be replayed by a program that was built with a different
+ * compiler.
+ */
+template <typename Event>
+struct event_encoder {};
+
+template <typename Event>
+    requires std::is_trivially_copyable_v<Event>
+struct event_encoder<Event> {
+    static void encode(const Event& ev, std::string& out) {
+        out.append(reinterpret_cast<const char*>(std::addressof(ev)), sizeof(Event));
+    }
+
+    static Event decode(std::string_view bytes) noexcept {
+        neo_assert(expects,
+                   bytes.size() == sizeof(Event),
+                   "Event log record does not have the size of the event type that it names",
+                   bytes.size(),
+                   sizeof(Event));
+        alignas(Event) std::byte buf[sizeof(Event)];
+        std::memcpy(buf, bytes.data(), sizeof(Event));
+        return *std::launder(reinterpret_cast<Event*>(buf));
+    }
+};
+
+/**
+ * @brief Match event types that can be written to an event log with `neo::event_encoder`.
+ */
+template <typename Event>
+concept recordable_event = requires(const Event& ev, std::string& out, std::string_view bytes) {
+    event_encoder<Event>::encode(ev, out);
+    { event_encoder<Event>::decode(bytes) } -> convertible_to<Event>;
+};
+
+namespace event_log_detail {
+
+template <typename Event>
+constexpr std::string_view event_name() noexcept {
+    if constexpr (requires { std::string_view(event_encoder<Event>::name); }) {
+        return event_encoder<Event>::name;
+    } else {
+        return neo::type_name<Event>();
+    }
+}
+
+/// FNV-1a
+constexpr std::uint64_t hash_name(std::string_view name) noexcept {
+    std::uint64_t h = 0xcbf2'9ce4'8422'2325;
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100'0000'01b3;
+    }
+    return h;
+}
+
+/// The identifier of an event type in an event log
+template <typename Event>
+constexpr std::uint64_t event_tag = hash_name(event_name<Event>());
+
+}  // namespace event_log_detail
+
+/**
+ * @brief Writes records of events to a binary event log file.
+ *
+ * The file starts with a fixed header, followed by a record for each event: The time of the
+ * event (in nanoseconds since the writer was opened), the tag of the event type, the size of
+ * the encoded event, and the encoded event. Integers are written in the byte order of the host.
+ * Records are buffered, and are written to the file when the buffer fills, on `flush()`, and
+ * when the writer is destroyed.
+ *
+ * An event_log_writer is not thread-safe.
+ */
+class event_log_writer {
+    std::FILE*                            _file = nullptr;
+    std::string                           _buffer;
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    std::uint64_t                         _count = 0;
+
+    void _write_record(std::uint64_t tag, auto&& encode_payload) {
+        const auto now  = std::chrono::steady_clock::now() - _start;
+        const auto time = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        // Reserve the header, and fill in the size once the payload has been encoded
+        const auto     header_pos = _buffer.size();
+        std::uint32_t  size       = 0;
+        constexpr auto header_len = sizeof time + sizeof tag + sizeof size;
+        _buffer.resize(header_pos + header_len);
+        encode_payload(_buffer);
+        size = static_cast<std::uint32_t>(_buffer.size() - header_pos - header_len);
+        auto header = _buffer.data() + header_pos;
+        std::memcpy(header, &time, sizeof time);
+        std::memcpy(header + sizeof time, &tag, sizeof tag);
+        std::memcpy(header + sizeof time + sizeof tag, &size, sizeof size);
+        ++_count;
+        if (_buffer.size() >= buffer_size) [[unlikely]] {
+            flush();
+        }
+    }
+
+public:
+    /// The size of the write buffer
+    static constexpr std::size_t buffer_size = 64 * 1024;
+
+    /**
+     * @brief Create or truncate the event log file at the given path.
+     *
+     * @throw std::system_error If the file cannot be opened
+     */
+    explicit event_log_writer(const std::filesystem::path& path);
+    ~event_log_writer();
+
+    event_log_writer(const event_log_writer&) = delete;
+
+    /// Append a record of the given event
+    template <recordable_event Event>
+    void write(const Event& ev) {
+        _write_record(event_log_detail::event_tag<Event>,
+                      [&](std::string& out) { event_encoder<Event>::encode(ev, out); });
+    }
+
+    /**
+     * @brief Write the buffered records to the file.
+     *
+     * @throw std::system_error If writing fails
+     */
+    void flush();
+
+    /// The number of records that have been written
+    [[nodiscard]] std::uint64_t size() const noexcept { return _count; }
+};
+
+/// A record that was read from an event log
+struct event_log_record {
+    /// The time of the event, in nanoseconds since the log was opened for writing
+    std::uint64_t time_ns;
+    /// The tag of the event type
+    std::uint64_t tag;
+    /// The encoded event. Only valid until the next record is read.
+    std::string_view payload;
+
+    /// Check whether the record holds an event of the given type
+    template <typename Event>
+    [[nodiscard]] bool is() const noexcept {
+        return tag == event_log_detail::event_tag<Event>;
+    }
+
+    /// Decode the event that is held in the record
+    template <recordable_event Event>
+    [[nodiscard]] Event get() const {
+        neo_assert(expects,
+                   is<Event>(),
+                   "Decoding an event log record as the wrong event type",
+                   event_log_detail::event_name<Event>());
+        return event_encoder<Event>::decode(payload);
+    }
+};
+
+/**
+ * @brief Reads the records of an event log file in order.
+ */
+class event_log_reader {
+    std::FILE*  _file = nullptr;
+    std::string _buffer;
+    std::size_t _pos = 0;
+
+    bool _fill(std::size_t n);
+
+public:
+    /**
+     * @brief Open the event log file at the given path.
+     *
+     * @throw std::system_error If the file cannot be opened, or if it is not an event log
+     */
+    explicit event_log_reader(const std::filesystem::path& path);
+    ~event_log_reader();
+
+    event_log_reader(const event_log_reader&) = delete;
+
+    /**
+     * @brief Read the next record of the log.
+     *
+     * @return The record, or nullopt at the end of the log. A record that was only partially
+     * written, such as by a process that crashed, ends the log.
+     * @throw std::system_error If reading fails
+     */
+    std::optional<event_log_record> next();
+};
+
+/**
+ * @brief Records every event of the given types that is emitted on the calling thread while it
+ * is in scope, to an event log file.
+ *
+ * The recorder installs a listener for each event type, which writes the event to the log and
+ * then bubbles it to the listener that was in scope before the recorder, so recording does not
+ * change how events are handled. Events that are emitted on other threads are not recorded.
+ *
+ * Event types that are bound to a `neo::static_listener` cannot be recorded.
+ *
+ * @tparam Events The event types to record. Each must be a `recordable_event`.
+ */
+template <recordable_event... Events>
+class event_recorder {
+    template <typename Event>
+    struct record_handler {
+        event_log_writer* writer;
+
+        emit_result_t<Event> operator()(const Event& ev) const {
+            writer->write(ev);
+            if constexpr (not event_bubbles<Event>) {
+                return neo::bubble_event(ev);
+            }
+        }
+    };
+
+    event_log_writer _writer;
+
+    std::tuple<listener<record_handler<Events>, Events>...> _listeners{
+        record_handler<Events>{&_writer}...};
+
+public:
+    /**
+     * @brief Start recording to the event log file at the given path, which is created or
+     * truncated.
+     *
+     * @throw std::system_error If the file cannot be opened
+     */
+    explicit event_recorder(const std::filesystem::path& path)
+        : _writer(path) {}
+
+    /// The writer of the event log
+    [[nodiscard]] event_log_writer&       writer() noexcept { return _writer; }
+    [[nodiscard]] const event_log_writer& writer() const noexcept { return _writer; }
+};
+
+/**
+ * @brief Emit the events of the given types that are recorded in an event log, in order, to
+ * the listeners of the calling thread.
+ *
+ * Records of other event types are skipped. Events are emitted as fast as they can be handled.
+ * Use `neo::event_log_reader` to pace the events by their recorded times.
+ *
+ * @return The number of events that were emitted.
+ * @throw std::system_error If the file cannot be opened or read
+ */
+template <recordable_event... Events>
+std::uint64_t replay_events(const std::filesystem::path& path) {
+    event_log_reader reader{path};
+    std::uint64_t    n = 0;
+    while (auto rec = reader.next()) {
+        const bool found = ((rec->is<Events>() ? (neo::emit(rec->get<Events>()), true) : false)
+                            or ...);
+        n += found ? 1 : 0;
+    }
+    return n;
+}
+
+}  // namespace neo
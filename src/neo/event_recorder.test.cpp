@@ -0,0 +1,177 @@
+#include "./event_recorder.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// A scratch file in the temporary directory
+struct scratch_file {
+    fs::path path;
+
+    explicit scratch_file(std::string name) {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path       = fs::temp_directory_path()
+            / ("neo-event_recorder-test-" + std::to_string(stamp) + "-" + name);
+    }
+
+    ~scratch_file() {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+};
+
+struct ev_tick {
+    int    seq;
+    double value;
+};
+
+struct ev_query {
+    using emit_result = int;
+    int key;
+};
+
+struct ev_message {
+    std::string text;
+};
+
+}  // namespace
+
+template <>
+struct neo::event_encoder<ev_message> {
+    static constexpr std::string_view name = "ev_message";
+
+    static void encode(const ev_message& ev, std::string& out) { out.append(ev.text); }
+    static ev_message decode(std::string_view bytes) { return ev_message{std::string(bytes)}; }
+};
+
+static_assert(neo::recordable_event<ev_tick>);
+static_assert(neo::recordable_event<ev_message>);
+static_assert(not neo::recordable_event<std::vector<int>>);
+
+TEST_CASE("Record and replay events") {
+    scratch_file     log{"ticks"};
+    std::vector<int> seen;
+    {
+        NEO_LISTEN(const ev_tick& ev) { seen.push_back(ev.seq); };
+        neo::event_recorder<ev_tick, ev_message> rec{log.path};
+        for (int i = 0; i < 5; ++i) {
+            neo::emit(ev_tick{i, i * 1.5});
+        }
+        neo::emit(ev_message{"hello"}, ev_message{""});
+        CHECK(rec.writer().size() == 7);
+    }
+    // Recording does not change what the handlers see
+    CHECK(seen == std::vector<int>{0, 1, 2, 3, 4});
+
+    std::vector<std::string> replayed;
+    NEO_LISTEN(const ev_tick& ev) {
+        replayed.push_back(std::to_string(ev.seq) + ":" + std::to_string(int(ev.value * 2)));
+    };
+    NEO_LISTEN(const ev_message& ev) { replayed.push_back(ev.text); };
+    CHECK(neo::replay_events<ev_tick, ev_message>(log.path) == 7);
+    CHECK(replayed == std::vector<std::string>{"0:0", "1:3", "2:6", "3:9", "4:12", "hello", ""});
+
+    // Only the requested event types are replayed
+    replayed.clear();
+    CHECK(neo::replay_events<ev_message>(log.path) == 2);
+    CHECK(replayed == std::vector<std::string>{"hello", ""});
+}
+
+TEST_CASE("Recording passes on emit results") {
+    scratch_file log{"query"};
+    NEO_LISTEN(ev_query q) { return q.key * 10; };
+    {
+        neo::event_recorder<ev_query> rec{log.path};
+        CHECK(neo::emit(ev_query{4}) == 40);
+    }
+    int sum = 0;
+    NEO_LISTEN(ev_query q) {
+        sum += q.key;
+        return 0;
+    };
+    CHECK(neo::replay_events<ev_query>(log.path) == 1);
+    CHECK(sum == 4);
+}
+
+TEST_CASE("Read the records of an event log") {
+    scratch_file log{"many"};
+    const int    n = 20'000;
+    {
+        neo::event_recorder<ev_tick> rec{log.path};
+        for (int i = 0; i < n; ++i) {
+            neo::emit(ev_tick{i, 0});
+        }
+        rec.writer().flush();
+        CHECK(fs::file_size(log.path) > neo::event_log_writer::buffer_size);
+    }
+    neo::event_log_reader reader{log.path};
+    int                   count     = 0;
+    std::uint64_t         prev_time = 0;
+    bool                  in_order  = true;
+    while (auto rec = reader.next()) {
+        in_order = in_order and rec->is<ev_tick>() and rec->get<ev_tick>().seq == count
+            and rec->time_ns >= prev_time;
+        prev_time = rec->time_ns;
+        ++count;
+    }
+    CHECK(in_order);
+    CHECK(count == n);
+}
+
+TEST_CASE("A truncated event log ends at the last whole record") {
+    scratch_file log{"truncated"};
+    {
+        neo::event_log_writer w{log.path};
+        w.write(ev_tick{1, 0});
+        w.write(ev_tick{2, 0});
+    }
+    fs::resize_file(log.path, fs::file_size(log.path) - 3);
+    std::vector<int> seen;
+    NEO_LISTEN(const ev_tick& ev) { seen.push_back(ev.seq); };
+    CHECK(neo::replay_events<ev_tick>(log.path) == 1);
+    CHECK(seen == std::vector<int>{1});
+}
+
+TEST_CASE("Event log errors") {
+    scratch_file log{"not-a-log"};
+    CHECK_THROWS_AS(neo::event_log_reader{log.path}, std::system_error);
+    std::ofstream{log.path} << "some text";
+    CHECK_THROWS_AS(neo::event_log_reader{log.path}, std::system_error);
+    CHECK_THROWS_AS(neo::event_log_writer{log.path / "child"}, std::system_error);
+    // A directory may open, but cannot be read
+    CHECK_THROWS_AS(neo::event_log_reader{fs::temp_directory_path()}, std::system_error);
+}
+
+TEST_CASE("Event recording throughput", "[.][benchmark]") {
+    scratch_file log{"bench"};
+    const int    n     = 10'000'000;
+    long long    total = 0;
+    NEO_LISTEN(const ev_tick& ev) { total += ev.seq; };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        neo::event_recorder<ev_tick> rec{log.path};
+        for (int i = 0; i < n; ++i) {
+            neo::emit(ev_tick{i, 0});
+        }
+    }
+    auto record_dur = std::chrono::steady_clock::now() - start;
+
+    start           = std::chrono::steady_clock::now();
+    auto n_read     = neo::replay_events<ev_tick>(log.path);
+    auto replay_dur = std::chrono::steady_clock::now() - start;
+    CHECK(n_read == n);
+    CHECK(total == 2 * ((long long)n * (n - 1) / 2));
+    auto ns = [&](auto d) { return std::chrono::duration<double, std::nano>(d).count() / n; };
+    std::printf("record: %5.2f ns, replay: %5.2f ns per event\n", ns(record_dur), ns(replay_dur));
+}
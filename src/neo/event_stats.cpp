@@ -0,0 +1,187 @@
+#include "./event_stats.hpp"
+
+#include "./event.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace neo;
+using event_stats_detail::thread_counters;
+using event_stats_detail::type_record;
+
+// See event.hpp. Only the one for the mode of this build is defined.
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+const int event_detail::event_stats_enabled = 1;
+#else
+const int event_detail::event_stats_disabled = 1;
+#endif
+
+namespace {
+
+std::mutex   registry_mtx;
+type_record* registry_head = nullptr;
+
+void subtract(event_stats& st, const event_stats& base) noexcept {
+    st.emits -= base.emits;
+    st.invocations -= base.invocations;
+    st.total_latency_ns -= base.total_latency_ns;
+    for (std::size_t i = 0; i < st.depth_histogram.size(); ++i) {
+        st.depth_histogram[i] -= base.depth_histogram[i];
+    }
+    for (std::size_t i = 0; i < st.latency_histogram.size(); ++i) {
+        st.latency_histogram[i] -= base.latency_histogram[i];
+    }
+}
+
+// Requires the registry lock
+event_stats totals_of(const type_record& rec) noexcept {
+    event_stats ret = rec.retired;
+    for (auto c = rec.threads; c; c = c->next) {
+        c->add_to(ret);
+    }
+    return ret;
+}
+
+std::string latency_label(std::uint64_t ns) {
+    if (ns >= 10'000'000'000) {
+        return std::to_string(ns / 1'000'000'000) + "s";
+    } else if (ns >= 10'000'000) {
+        return std::to_string(ns / 1'000'000) + "ms";
+    } else if (ns >= 10'000) {
+        return std::to_string(ns / 1'000) + "us";
+    }
+    return std::to_string(ns) + "ns";
+}
+
+}  // namespace
+
+type_record::type_record(std::string_view n)
+    : name(n) {
+    std::scoped_lock lk{registry_mtx};
+    next          = registry_head;
+    registry_head = this;
+}
+
+thread_counters::thread_counters(type_record& t)
+    : type(t) {
+    std::scoped_lock lk{registry_mtx};
+    next = type.threads;
+    if (next) {
+        next->prev = this;
+    }
+    type.threads = this;
+}
+
+thread_counters::~thread_counters() {
+    std::scoped_lock lk{registry_mtx};
+    add_to(type.retired);
+    if (prev) {
+        prev->next = next;
+    } else {
+        type.threads = next;
+    }
+    if (next) {
+        next->prev = prev;
+    }
+}
+
+void thread_counters::add_to(event_stats& st) const noexcept {
+    st.emits += emits.load(std::memory_order_relaxed);
+    st.invocations += invocations.load(std::memory_order_relaxed);
+    st.total_latency_ns += total_latency_ns.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < event_stats::n_depth_buckets; ++i) {
+        st.depth_histogram[i] += depth_histogram[i].load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < event_stats::n_latency_buckets; ++i) {
+        st.latency_histogram[i] += latency_histogram[i].load(std::memory_order_relaxed);
+    }
+}
+
+event_stats event_stats_detail::snapshot(type_record& rec) noexcept {
+    event_stats ret;
+    {
+        std::scoped_lock lk{registry_mtx};
+        ret = totals_of(rec);
+        subtract(ret, rec.baseline);
+    }
+    ret.event_type = rec.name;
+    ret.unhandled  = ret.depth_histogram[0];
+    return ret;
+}
+
+double event_stats::mean_latency_ns() const noexcept {
+    const auto handled = emits - unhandled;
+    return handled ? static_cast<double>(total_latency_ns) / static_cast<double>(handled) : 0.0;
+}
+
+std::uint64_t event_stats::latency_percentile_ns(double p) const noexcept {
+    std::uint64_t total = 0;
+    for (auto n : latency_histogram) {
+        total += n;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // The rank of the sample at the percentile, counting from one
+    const auto rank = std::max(std::uint64_t(1),
+                               static_cast<std::uint64_t>(
+                                   std::ceil(p / 100.0 * static_cast<double>(total))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < n_latency_buckets; ++i) {
+        seen += latency_histogram[i];
+        if (seen >= rank) {
+            return i + 1 < n_latency_buckets ? latency_bucket_floor(i + 1) - 1
+                                             : latency_bucket_floor(i);
+        }
+    }
+    return latency_bucket_floor(n_latency_buckets - 1);
+}
+
+std::string event_stats::latency_histogram_string() const {
+    std::string ret;
+    for (std::size_t i = 0; i < n_latency_buckets; ++i) {
+        if (latency_histogram[i] == 0) {
+            continue;
+        }
+        if (not ret.empty()) {
+            ret += ", ";
+        }
+        ret += latency_label(latency_bucket_floor(i));
+        if (i + 1 < n_latency_buckets) {
+            ret += "-";
+            ret += latency_label(latency_bucket_floor(i + 1) - 1);
+        } else {
+            ret += "+";
+        }
+        ret += ": ";
+        ret += std::to_string(latency_histogram[i]);
+    }
+    return ret;
+}
+
+std::vector<event_stats> neo::event_dispatch_stats() {
+    std::vector<type_record*> records;
+    {
+        std::scoped_lock lk{registry_mtx};
+        for (auto r = registry_head; r; r = r->next) {
+            records.push_back(r);
+        }
+    }
+    std::vector<event_stats> ret;
+    ret.reserve(records.size());
+    for (auto r : records) {
+        ret.push_back(event_stats_detail::snapshot(*r));
+    }
+    std::sort(ret.begin(), ret.end(), [](auto& a, auto& b) { return a.event_type < b.event_type; });
+    return ret;
+}
+
+void neo::reset_event_dispatch_stats() noexcept {
+    // The counters are only written by their own threads, so record where they are now, and
+    // count from there
+    std::scoped_lock lk{registry_mtx};
+    for (auto r = registry_head; r; r = r->next) {
+        r->baseline = totals_of(*r);
+    }
+}
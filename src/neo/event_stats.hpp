@@ -0,0 +1,240 @@
+#pragma once
+
+#include "./config-pp.hpp"
+#include "./config.hpp"
+#include "./type_name.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neo {
+
+/**
+ * @brief Whether event dispatch statistics are being recorded.
+ *
+ * Statistics are opt-in: Define `Neo_ToggleFeature_EventStats` to `Enabled` in
+ * `<neo-tweaks.hpp>` to have `neo::emit()` count each event and time its handlers. The setting
+ * must be the same for the library and for every translation unit of the program. A program
+ * that mixes the two fails to link.
+ */
+constexpr bool event_dispatch_stats_enabled = NEO_FeatureIsEnabled(Neo, EventStats);
+
+/**
+ * @brief A snapshot of the dispatch statistics of one event type, summed over all threads.
+ *
+ * Events are counted by their `emit_as_t` type.
+ */
+struct event_stats {
+    /// The number of buckets in the histogram of handler depths
+    static constexpr std::size_t n_depth_buckets = 8;
+
+    /**
+     * @brief The number of buckets in the histogram of dispatch latencies.
+     *
+     * The histogram is log-linear: Each power of two is split into four buckets, so each
+     * bucket is at most 25% wider than its lower bound. Latencies below 4ns have a bucket
+     * each, and the last bucket holds every latency of 2^41ns (about 36 minutes) or more.
+     */
+    static constexpr std::size_t n_latency_buckets = 160;
+
+    using depth_histogram_type   = std::array<std::uint64_t, n_depth_buckets>;
+    using latency_histogram_type = std::array<std::uint64_t, n_latency_buckets>;
+
+    /// The name of the event type
+    std::string_view event_type;
+    /// The number of times the event was emitted, including when no one was listening
+    std::uint64_t emits = 0;
+    /// The number of emits that found no listener
+    std::uint64_t unhandled = 0;
+    /// The number of times a handler was invoked, including for bubbled events
+    std::uint64_t invocations = 0;
+    /// The sum of the dispatch latencies of handled emits, in nanoseconds
+    std::uint64_t total_latency_ns = 0;
+    /// The number of emits that ran `i` handlers. The last bucket counts all deeper emits.
+    depth_histogram_type depth_histogram = {};
+    /// The number of handled emits in each latency bucket. See `latency_bucket_floor()`.
+    latency_histogram_type latency_histogram = {};
+
+    /// The number of handler invocations that were caused by bubbling an event
+    [[nodiscard]] std::uint64_t bubbles() const noexcept {
+        return invocations - (emits - unhandled);
+    }
+
+    /// The mean time to dispatch a handled emit, in nanoseconds
+    [[nodiscard]] double mean_latency_ns() const noexcept;
+
+    /**
+     * @brief Estimate a latency percentile, in nanoseconds.
+     *
+     * @param p The percentile, between 0 and 100.
+     * @return The upper bound of the bucket that holds the percentile, which is at most 25%
+     * above the true value. Zero if no handled emits were recorded.
+     */
+    [[nodiscard]] std::uint64_t latency_percentile_ns(double p) const noexcept;
+
+    /// The smallest latency (in nanoseconds) that is recorded in the given bucket
+    static constexpr std::uint64_t latency_bucket_floor(std::size_t bucket) noexcept {
+        if (bucket < 4) {
+            return bucket;
+        }
+        const auto msb = bucket / 4 + 1;
+        return (std::uint64_t(4) + bucket % 4) << (msb - 2);
+    }
+
+    /// The latency bucket that records the given latency
+    static constexpr std::size_t latency_bucket(std::uint64_t ns) noexcept {
+        if (ns < 4) {
+            return static_cast<std::size_t>(ns);
+        }
+        const auto msb    = static_cast<std::size_t>(std::bit_width(ns)) - 1;
+        const auto sub    = static_cast<std::size_t>(ns >> (msb - 2)) & 3;
+        const auto bucket = (msb - 1) * 4 + sub;
+        return bucket < n_latency_buckets ? bucket : n_latency_buckets - 1;
+    }
+
+    /// Render the nonzero buckets of the latency histogram
+    std::string latency_histogram_string() const;
+
+    friend void do_repr(auto out, const event_stats* self) {
+        out.type("neo::event_stats");
+        if (self) {
+            out.bracket_value("event_type={}, emits={}, unhandled={}, bubbles={}, "
+                              "mean_latency_ns={}, p50<={}, p99<={}, p999<={}",
+                              out.repr_value(self->event_type),
+                              self->emits,
+                              self->unhandled,
+                              self->bubbles(),
+                              self->mean_latency_ns(),
+                              self->latency_percentile_ns(50),
+                              self->latency_percentile_ns(99),
+                              self->latency_percentile_ns(99.9));
+        }
+    }
+};
+
+namespace event_stats_detail {
+
+struct type_record;
+
+/**
+ * @brief The counters of one event type on one thread.
+ *
+ * Only the owning thread writes to the counters, so they need not be updated atomically,
+ * but they are atomic objects so that snapshots may read them from other threads.
+ */
+struct thread_counters {
+    std::atomic<std::uint64_t> emits{0};
+    std::atomic<std::uint64_t> invocations{0};
+    std::atomic<std::uint64_t> total_latency_ns{0};
+    std::atomic<std::uint64_t> depth_histogram[event_stats::n_depth_buckets]     = {};
+    std::atomic<std::uint64_t> latency_histogram[event_stats::n_latency_buckets] = {};
+
+    type_record&     type;
+    thread_counters* next = nullptr;
+    thread_counters* prev = nullptr;
+
+    explicit thread_counters(type_record& t);
+    // Folds the counters into the type's totals
+    ~thread_counters();
+
+    static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n = 1) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void add_to(event_stats& st) const noexcept;
+
+    void on_emit(std::uint64_t depth, std::uint64_t latency_ns) noexcept {
+        bump(emits);
+        bump(depth_histogram[depth < event_stats::n_depth_buckets
+                                 ? depth
+                                 : event_stats::n_depth_buckets - 1]);
+        if (depth != 0) {
+            bump(total_latency_ns, latency_ns);
+            bump(latency_histogram[event_stats::latency_bucket(latency_ns)]);
+        }
+    }
+};
+
+/// The registration of an event type. Holds the counters of threads that have exited.
+struct type_record {
+    std::string_view name;
+    type_record*     next    = nullptr;
+    thread_counters* threads = nullptr;
+    // The counts of threads that have exited, and the totals at the time of the last reset
+    event_stats retired;
+    event_stats baseline;
+
+    explicit type_record(std::string_view name);
+};
+
+template <typename Event>
+type_record& type_record_for() {
+    static type_record rec{neo::type_name<Event>()};
+    return rec;
+}
+
+template <typename Event>
+thread_counters& counters_for() {
+    thread_local thread_counters c{type_record_for<Event>()};
+    return c;
+}
+
+/// Records one emit of an event while it is in scope
+template <typename Event>
+class emit_recorder {
+    using clock = std::chrono::steady_clock;
+
+    thread_counters&  _c                  = counters_for<Event>();
+    std::uint64_t     _invocations_before = _c.invocations.load(std::memory_order_relaxed);
+    clock::time_point _start              = clock::now();
+
+public:
+    emit_recorder() = default;
+
+    ~emit_recorder() {
+        const auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()
+                                                                              - _start);
+        _c.on_emit(_c.invocations.load(std::memory_order_relaxed) - _invocations_before,
+                   static_cast<std::uint64_t>(dur.count()));
+    }
+};
+
+template <typename Event>
+void record_unhandled() noexcept {
+    counters_for<Event>().on_emit(0, 0);
+}
+
+template <typename Event>
+void record_invocation() noexcept {
+    thread_counters::bump(counters_for<Event>().invocations);
+}
+
+event_stats snapshot(type_record& rec) noexcept;
+
+}  // namespace event_stats_detail
+
+/**
+ * @brief Get the dispatch statistics of every event type that has been emitted.
+ *
+ * The result is ordered by `event_type`. It lists every event type that has been registered
+ * by recording an emit, which only happens when `event_dispatch_stats_enabled`.
+ */
+std::vector<event_stats> event_dispatch_stats();
+
+/// Get the dispatch statistics of the given event type
+template <typename Event>
+event_stats event_dispatch_stats() {
+    return event_stats_detail::snapshot(event_stats_detail::type_record_for<Event>());
+}
+
+/// Reset the dispatch statistics of every event type, on every thread
+void reset_event_dispatch_stats() noexcept;
+
+}  // namespace neo
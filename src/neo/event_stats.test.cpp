@@ -0,0 +1,150 @@
+#include "./event_stats.hpp"
+
+#include "./event.hpp"
+#include "./repr.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <thread>
+
+#if NEO_FeatureIsEnabled(Neo, EventStats)
+
+namespace {
+
+struct counted_event {
+    int value;
+};
+
+struct unheard_event {};
+
+struct threaded_event {};
+
+std::uint64_t histogram_total(const auto& h) {
+    return std::accumulate(h.begin(), h.end(), std::uint64_t(0));
+}
+
+}  // namespace
+
+TEST_CASE("Count emits and handlers") {
+    neo::reset_event_dispatch_stats();
+    neo::emit(counted_event{1});
+    {
+        NEO_LISTEN(counted_event) {};
+        neo::emit(counted_event{2}, counted_event{3});
+    }
+    auto stats = neo::event_dispatch_stats<counted_event>();
+    CHECK_THAT(std::string(stats.event_type), Catch::Contains("counted_event"));
+    CHECK(stats.emits == 3);
+    CHECK(stats.unhandled == 1);
+    CHECK(stats.invocations == 2);
+    CHECK(stats.bubbles() == 0);
+    CHECK(stats.depth_histogram[0] == 1);
+    CHECK(stats.depth_histogram[1] == 2);
+    CHECK(histogram_total(stats.latency_histogram) == 2);
+}
+
+TEST_CASE("Count bubbled events") {
+    neo::reset_event_dispatch_stats();
+    int seen = 0;
+    NEO_LISTEN(counted_event) { ++seen; };
+    NEO_LISTEN(counted_event ev) { neo::bubble_event(ev); };
+    NEO_LISTEN(counted_event ev) {
+        if (ev.value % 2) {
+            neo::bubble_event(ev);
+        }
+    };
+    neo::emit(counted_event{1}, counted_event{2});
+    CHECK(seen == 1);
+
+    auto stats = neo::event_dispatch_stats<counted_event>();
+    CHECK(stats.emits == 2);
+    CHECK(stats.unhandled == 0);
+    CHECK(stats.invocations == 4);
+    CHECK(stats.bubbles() == 2);
+    CHECK(stats.depth_histogram[1] == 1);
+    CHECK(stats.depth_histogram[3] == 1);
+}
+
+TEST_CASE("Events that are never handled have no latencies") {
+    neo::reset_event_dispatch_stats();
+    for (int i = 0; i < 10; ++i) {
+        neo::emit(unheard_event{});
+    }
+    auto stats = neo::event_dispatch_stats<unheard_event>();
+    CHECK(stats.emits == 10);
+    CHECK(stats.unhandled == 10);
+    CHECK(stats.invocations == 0);
+    CHECK(histogram_total(stats.latency_histogram) == 0);
+    CHECK(stats.mean_latency_ns() == 0);
+    CHECK(stats.latency_percentile_ns(99) == 0);
+    CHECK(stats.latency_histogram_string().empty());
+}
+
+TEST_CASE("Statistics of exited threads are kept") {
+    neo::reset_event_dispatch_stats();
+    NEO_LISTEN(threaded_event) {};
+    neo::emit(threaded_event{});
+    std::thread([] {
+        // Listeners are per-thread, so this one is unhandled
+        neo::emit(threaded_event{}, threaded_event{});
+    }).join();
+    auto stats = neo::event_dispatch_stats<threaded_event>();
+    CHECK(stats.emits == 3);
+    CHECK(stats.unhandled == 2);
+    CHECK(stats.invocations == 1);
+
+    auto all = neo::event_dispatch_stats();
+    CHECK(std::ranges::is_sorted(all, std::less<>{}, &neo::event_stats::event_type));
+    CHECK(std::ranges::count(all, stats.event_type, &neo::event_stats::event_type) == 1);
+}
+
+TEST_CASE("Reset dispatch statistics") {
+    NEO_LISTEN(counted_event) {};
+    neo::emit(counted_event{1});
+    neo::reset_event_dispatch_stats();
+    auto stats = neo::event_dispatch_stats<counted_event>();
+    CHECK(stats.emits == 0);
+    CHECK(stats.invocations == 0);
+    CHECK(histogram_total(stats.depth_histogram) == 0);
+    CHECK(histogram_total(stats.latency_histogram) == 0);
+    neo::emit(counted_event{1});
+    CHECK(neo::event_dispatch_stats<counted_event>().emits == 1);
+}
+
+TEST_CASE("repr() of dispatch statistics") {
+    NEO_LISTEN(counted_event) {};
+    neo::emit(counted_event{1});
+    auto stats = neo::event_dispatch_stats<counted_event>();
+    auto repr  = neo::repr(stats).string();
+    CHECK_THAT(repr, Catch::Contains("neo::event_stats"));
+    CHECK_THAT(repr, Catch::Contains("counted_event"));
+    CHECK_THAT(repr, Catch::Contains("p99<="));
+    CHECK_FALSE(stats.latency_histogram_string().empty());
+}
+
+#endif
+
+static_assert([] {
+    using st = neo::event_stats;
+    for (std::size_t i = 0; i < st::n_latency_buckets; ++i) {
+        if (st::latency_bucket(st::latency_bucket_floor(i)) != i) {
+            return false;
+        }
+        if (i + 1 < st::n_latency_buckets
+            && st::latency_bucket(st::latency_bucket_floor(i + 1) - 1) != i) {
+            return false;
+        }
+    }
+    return st::latency_bucket(~std::uint64_t(0)) == st::n_latency_buckets - 1;
+}());
+
+TEST_CASE("Latency percentiles") {
+    neo::event_stats st;
+    st.latency_histogram[neo::event_stats::latency_bucket(100)] = 98;
+    st.latency_histogram[neo::event_stats::latency_bucket(5000)] = 2;
+    CHECK(st.latency_percentile_ns(50) >= 100);
+    CHECK(st.latency_percentile_ns(50) < 125);
+    CHECK(st.latency_percentile_ns(99) >= 5000);
+    CHECK(st.latency_percentile_ns(99) < 6250);
+}
@@ -0,0 +1,94 @@
+#include "./frame_alloc.hpp"
+
+#include <array>
+
+using namespace neo;
+
+namespace {
+
+/// Size granularity of the cached frames
+constexpr std::size_t granule_size = 64;
+/// The number of size classes. Frames larger than granule_size * n_classes are not cached.
+constexpr std::size_t n_classes = 16;
+/// The maximum number of frames that we will hold in each size class
+constexpr std::size_t max_cached_per_class = 64;
+
+constexpr std::size_t max_cached_size = granule_size * n_classes;
+
+struct free_node {
+    free_node* next;
+};
+
+/**
+ * @brief A per-thread cache of freed coroutine frames, segregated by size class.
+ */
+struct frame_cache {
+    std::array<free_node*, n_classes>  heads{};
+    std::array<std::size_t, n_classes> counts{};
+
+    void release() noexcept {
+        for (auto& head : heads) {
+            while (head) {
+                auto next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+        counts = {};
+    }
+
+    ~frame_cache();
+};
+
+thread_local frame_cache tl_frame_cache;
+/// Set when the thread's cache is destroyed. Frames freed after this are given back to the
+/// global allocator. (This is trivially destructible, so it remains usable for the whole thread.)
+thread_local bool tl_frame_cache_destroyed = false;
+
+frame_cache::~frame_cache() {
+    release();
+    tl_frame_cache_destroyed = true;
+}
+
+constexpr std::size_t size_class_of(std::size_t size) noexcept {
+    return (size - 1) / granule_size;
+}
+
+}  // namespace
+
+void* neo::recycled_frame_allocate(std::size_t size) {
+    if (size == 0 or size > max_cached_size or tl_frame_cache_destroyed) {
+        return ::operator new(size);
+    }
+    const auto cls   = size_class_of(size);
+    auto&      cache = tl_frame_cache;
+    if (auto node = cache.heads[cls]) {
+        cache.heads[cls] = node->next;
+        --cache.counts[cls];
+        return node;
+    }
+    // Allocate the full size of the class so that it can be reused for any frame in the class
+    return ::operator new((cls + 1) * granule_size);
+}
+
+void neo::recycled_frame_deallocate(void* ptr, std::size_t size) noexcept {
+    if (size == 0 or size > max_cached_size or tl_frame_cache_destroyed) {
+        ::operator delete(ptr);
+        return;
+    }
+    const auto cls   = size_class_of(size);
+    auto&      cache = tl_frame_cache;
+    if (cache.counts[cls] == max_cached_per_class) {
+        ::operator delete(ptr);
+        return;
+    }
+    auto node        = ::new (ptr) free_node{cache.heads[cls]};
+    cache.heads[cls] = node;
+    ++cache.counts[cls];
+}
+
+void neo::release_recycled_frames() noexcept {
+    if (not tl_frame_cache_destroyed) {
+        tl_frame_cache.release();
+    }
+}
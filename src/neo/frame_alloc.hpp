@@ -0,0 +1,293 @@
+#pragma once
+
+#include "./attrib.hpp"
+#include "./config-pp.hpp"
+#include "./config.hpp"
+#include "./fixed_string.hpp"
+#include "./fwd.hpp"
+#include "./memory.hpp"
+#include "./platform.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+
+namespace neo {
+
+/**
+ * @brief Allocate storage for a coroutine frame from the calling thread's frame cache.
+ *
+ * Small allocations are served from a per-thread set of size-bucketed free-lists,
+ * which are populated by `recycled_frame_deallocate`. Large allocations go
+ * directly to the global `operator new`.
+ *
+ * @param size The number of bytes to allocate.
+ */
+[[nodiscard]] void* recycled_frame_allocate(std::size_t size);
+
+/**
+ * @brief Return storage obtained from `recycled_frame_allocate` to the calling
+ * thread's frame cache.
+ *
+ * @param ptr A pointer returned by `recycled_frame_allocate`
+ * @param size The same size that was given to `recycled_frame_allocate`
+ *
+ * The storage may be freed on a different thread than it was allocated on.
+ */
+void recycled_frame_deallocate(void* ptr, std::size_t size) noexcept;
+
+/**
+ * @brief Release all cached frame storage that is held by the calling thread.
+ */
+void release_recycled_frames() noexcept;
+
+namespace frame_alloc_detail {
+
+/// The alignment of all frame allocations, and of the allocation trailer
+constexpr std::size_t frame_align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+/// Block type used to allocate from user-provided allocators.
+struct alignas(frame_align) frame_block {
+    std::byte bytes[frame_align];
+};
+
+/// Type of the function that knows how to deallocate a frame
+using dealloc_fn = void(void* frame, std::size_t frame_size) noexcept;
+
+/// Compute the offset of the allocation trailer relative to the beginning of the frame
+constexpr std::size_t trailer_offset(std::size_t frame_size) noexcept {
+    return (frame_size + frame_align - 1) & ~(frame_align - 1);
+}
+
+/**
+ * @brief Data that is placed immediately after the coroutine frame (at a fixed
+ * alignment) that records how the frame was allocated.
+ *
+ * The deallocation function must be the first member, since we do not know the
+ * allocator type at the point of deallocation.
+ */
+template <typename Alloc>
+struct trailer {
+    dealloc_fn*                 dealloc;
+    NEO_NO_UNIQUE_ADDRESS Alloc alloc;
+};
+
+template <>
+struct trailer<void> {
+    dealloc_fn* dealloc;
+};
+
+template <typename Alloc>
+constexpr std::size_t total_size(std::size_t frame_size) noexcept {
+    return trailer_offset(frame_size) + sizeof(trailer<Alloc>);
+}
+
+template <typename Alloc>
+constexpr std::size_t block_count(std::size_t frame_size) noexcept {
+    return (total_size<Alloc>(frame_size) + sizeof(frame_block) - 1) / sizeof(frame_block);
+}
+
+template <typename Alloc>
+trailer<Alloc>* get_trailer(void* frame, std::size_t frame_size) noexcept {
+    return static_cast<trailer<Alloc>*>(
+        static_cast<void*>(static_cast<std::byte*>(frame) + trailer_offset(frame_size)));
+}
+
+inline void dealloc_recycled(void* frame, std::size_t frame_size) noexcept {
+    recycled_frame_deallocate(frame, total_size<void>(frame_size));
+}
+
+template <typename Alloc>
+void dealloc_with(void* frame, std::size_t frame_size) noexcept {
+    auto  tr    = get_trailer<Alloc>(frame, frame_size);
+    Alloc alloc = NEO_MOVE(tr->alloc);
+    std::destroy_at(tr);
+    std::allocator_traits<Alloc>::deallocate(alloc,
+                                             static_cast<frame_block*>(frame),
+                                             block_count<Alloc>(frame_size));
+}
+
+inline void* allocate_recycled(std::size_t frame_size) {
+    void* frame = recycled_frame_allocate(total_size<void>(frame_size));
+    ::new (get_trailer<void>(frame, frame_size)) trailer<void>{&dealloc_recycled};
+    return frame;
+}
+
+template <typename Alloc>
+void* allocate_with(std::size_t frame_size, const Alloc& user_alloc) {
+    using block_alloc = rebind_alloc_t<Alloc, frame_block>;
+    static_assert(alignof(trailer<block_alloc>) <= frame_align,
+                  "Over-aligned allocators cannot be used to allocate coroutine frames");
+    block_alloc alloc(user_alloc);
+    auto        frame = std::allocator_traits<block_alloc>::allocate(alloc,
+                                                              block_count<block_alloc>(frame_size));
+    ::new (get_trailer<block_alloc>(frame, frame_size))
+        trailer<block_alloc>{&dealloc_with<block_alloc>, NEO_MOVE(alloc)};
+    return frame;
+}
+
+}  // namespace frame_alloc_detail
+
+/**
+ * @brief A base class for coroutine promise types that controls the allocation
+ * of the coroutine frame.
+ *
+ * If the first parameter of the coroutine is `std::allocator_arg_t`, then the
+ * second parameter is used as an allocator for the coroutine frame. (For member
+ * function coroutines, the allocator parameters follow the implicit object
+ * parameter.) A copy of the allocator is stored alongside the frame so that it
+ * can be used for deallocation.
+ *
+ * If no allocator is given, the frame is allocated with `recycled_frame_allocate`,
+ * which reuses recently freed frames on the same thread.
+ */
+class frame_alloc_promise_base {
+public:
+    /// Allocate a frame for a coroutine invoked with a leading allocator_arg_t
+    template <typename Alloc, typename... Args>
+    static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc,
+                              const Args&...) {
+        return frame_alloc_detail::allocate_with(size, alloc);
+    }
+
+    /// Allocate a frame for a member function coroutine with a leading allocator_arg_t
+    template <typename This, typename Alloc, typename... Args>
+    static void* operator new(std::size_t size, const This&, std::allocator_arg_t,
+                              const Alloc& alloc, const Args&...) {
+        return frame_alloc_detail::allocate_with(size, alloc);
+    }
+
+    /// Allocate a frame using the thread's frame recycler
+    template <typename... Args>
+    static void* operator new(std::size_t size, const Args&...) {
+        return frame_alloc_detail::allocate_recycled(size);
+    }
+
+    NEO_ALWAYS_INLINE static void operator delete(void* frame, std::size_t size) noexcept {
+        auto tr = frame_alloc_detail::get_trailer<void>(frame, size);
+        tr->dealloc(frame, size);
+    }
+};
+
+namespace frame_alloc_detail {
+
+/// The number of buckets in each histogram of `frame_counters`
+constexpr std::size_t n_stat_buckets = 9;
+
+/**
+ * @brief Counters for the frames of one kind of coroutine. Created on first use, and
+ * registered in a global list that is read by `coroutine_frame_stats()`.
+ */
+struct frame_counters {
+    std::string_view           kind;
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> live{0};
+    std::atomic<std::uint64_t> peak_live{0};
+    std::atomic<std::uint64_t> total_bytes{0};
+    std::atomic<std::uint64_t> size_histogram[n_stat_buckets]     = {};
+    std::atomic<std::uint64_t> lifetime_histogram[n_stat_buckets] = {};
+    frame_counters*            next                               = nullptr;
+
+    explicit frame_counters(std::string_view kind) noexcept;
+
+    void on_allocate(std::size_t size) noexcept;
+    void on_deallocate(std::int64_t lifetime_ns) noexcept;
+};
+
+/// Get the counters for the given kind of coroutine
+template <basic_fixed_string Kind>
+frame_counters& counters_for() noexcept {
+    static frame_counters c{Kind};
+    return c;
+}
+
+/// The current time of a monotonic clock, in nanoseconds
+std::int64_t frame_clock_now() noexcept;
+
+}  // namespace frame_alloc_detail
+
+/**
+ * @brief A `frame_alloc_promise_base` that also records statistics about the frames of its
+ * coroutines. See `<neo/frame_stats.hpp>`.
+ *
+ * The creation time of each frame is stored after the frame, to measure its lifetime.
+ *
+ * @tparam Kind The name under which the statistics are recorded.
+ */
+template <basic_fixed_string Kind>
+class counted_frame_alloc_promise_base : public frame_alloc_promise_base {
+    static constexpr std::size_t stamp_size = sizeof(std::int64_t);
+
+    static void* _on_allocate(void* frame, std::size_t size) noexcept {
+        const auto now = frame_alloc_detail::frame_clock_now();
+        std::memcpy(static_cast<std::byte*>(frame) + size, &now, stamp_size);
+        frame_alloc_detail::counters_for<Kind>().on_allocate(size);
+        return frame;
+    }
+
+public:
+    template <typename... Args>
+    static void* operator new(std::size_t size, const Args&... args) {
+        return _on_allocate(frame_alloc_promise_base::operator new(size + stamp_size, args...),
+                            size);
+    }
+
+    // Always inlined, like the operator of the base class. Otherwise GCC sees a call to this
+    // operator on a frame that came from the (inlined) global operator new, and warns.
+    NEO_ALWAYS_INLINE static void operator delete(void* frame, std::size_t size) noexcept {
+        std::int64_t created;
+        std::memcpy(&created, static_cast<std::byte*>(frame) + size, stamp_size);
+        const auto lifetime = frame_alloc_detail::frame_clock_now() - created;
+        frame_alloc_detail::counters_for<Kind>().on_deallocate(lifetime);
+        frame_alloc_promise_base::operator delete(frame, size + stamp_size);
+    }
+};
+
+/**
+ * @brief The promise base class that the coroutine types of neo-fun use to allocate their
+ * frames.
+ *
+ * This is `frame_alloc_promise_base`, unless the `Neo_ToggleFeature_CoroFrameStats` feature is
+ * `Enabled`, in which case it is `counted_frame_alloc_promise_base<Kind>`.
+ */
+#if NEO_FeatureIsEnabled(Neo, CoroFrameStats)
+template <basic_fixed_string Kind>
+using frame_alloc_promise_base_for = counted_frame_alloc_promise_base<Kind>;
+#else
+template <basic_fixed_string Kind>
+using frame_alloc_promise_base_for = frame_alloc_promise_base;
+#endif
+
+namespace frame_alloc_detail {
+
+/*
+ * The feature changes the promise types of neo-fun, so it must be the same in every translation
+ * unit of a program. The library defines only the one of these that matches its own build, and
+ * each translation unit refers to the one for its own setting, so a program that mixes the two
+ * fails to link.
+ */
+extern const int coro_frame_stats_enabled;
+extern const int coro_frame_stats_disabled;
+
+#if NEO_FeatureIsEnabled(Neo, CoroFrameStats)
+#if NEO_COMPILER(MSVC)
+#pragma detect_mismatch("neo_CoroFrameStats", "Enabled")
+#elif NEO_COMPILER(GNU, Clang)
+[[gnu::used]] static const int* const coro_frame_stats_mode = &coro_frame_stats_enabled;
+#endif
+#else
+#if NEO_COMPILER(MSVC)
+#pragma detect_mismatch("neo_CoroFrameStats", "Disabled")
+#elif NEO_COMPILER(GNU, Clang)
+[[gnu::used]] static const int* const coro_frame_stats_mode = &coro_frame_stats_disabled;
+#endif
+#endif
+
+}  // namespace frame_alloc_detail
+
+}  // namespace neo
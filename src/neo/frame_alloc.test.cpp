@@ -0,0 +1,109 @@
+#include "./frame_alloc.hpp"
+
+#include "./testing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <coroutine>
+#include <memory>
+
+using neo::testing::alloc_stats;
+using neo::testing::counting_allocator;
+
+namespace {
+
+struct simple_task {
+    struct promise_type : neo::frame_alloc_promise_base {
+        simple_task get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() { throw; }
+    };
+
+    std::coroutine_handle<promise_type> co;
+
+    ~simple_task() { co.destroy(); }
+};
+
+simple_task with_alloc(std::allocator_arg_t, counting_allocator<int>, int& out) {
+    out = 42;
+    co_return;
+}
+
+simple_task no_alloc(int& out) {
+    out = 1729;
+    co_return;
+}
+
+struct has_member_coro {
+    int value = 31;
+
+    simple_task run(std::allocator_arg_t, counting_allocator<char>, int& out) {
+        out = value;
+        co_return;
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Allocate a coroutine frame with an allocator") {
+    alloc_stats stats;
+    int         n = 0;
+    {
+        auto t = with_alloc(std::allocator_arg, counting_allocator<int>{stats}, n);
+        CHECK(stats.n_allocs == 1);
+        CHECK(stats.n_deallocs == 0);
+        t.co.resume();
+        CHECK(n == 42);
+    }
+    CHECK(stats.n_allocs == 1);
+    CHECK(stats.n_deallocs == 1);
+}
+
+TEST_CASE("Allocate a member coroutine frame with an allocator") {
+    alloc_stats     stats;
+    has_member_coro m;
+    int             n = 0;
+    {
+        auto t = m.run(std::allocator_arg, counting_allocator<char>{stats}, n);
+        t.co.resume();
+        CHECK(n == 31);
+    }
+    CHECK(stats.n_allocs == 1);
+    CHECK(stats.n_deallocs == 1);
+}
+
+TEST_CASE("Recycle coroutine frames") {
+    neo::release_recycled_frames();
+    int   n = 0;
+    void* first_frame;
+    {
+        auto t      = no_alloc(n);
+        first_frame = t.co.address();
+        t.co.resume();
+        CHECK(n == 1729);
+    }
+    {
+        // The next frame of the same size should reuse the storage of the prior frame
+        auto t = no_alloc(n);
+        CHECK(t.co.address() == first_frame);
+    }
+    neo::release_recycled_frames();
+}
+
+TEST_CASE("Recycle raw storage") {
+    neo::release_recycled_frames();
+    void* p = neo::recycled_frame_allocate(100);
+    neo::recycled_frame_deallocate(p, 100);
+    // A different size within the same size class will reuse it
+    void* q = neo::recycled_frame_allocate(120);
+    CHECK(p == q);
+    neo::recycled_frame_deallocate(q, 120);
+    // Large allocations are not cached
+    void* big = neo::recycled_frame_allocate(1024 * 1024);
+    neo::recycled_frame_deallocate(big, 1024 * 1024);
+    neo::release_recycled_frames();
+}
@@ -0,0 +1,164 @@
+#include "./frame_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+using namespace neo;
+using frame_alloc_detail::frame_counters;
+
+namespace {
+
+std::mutex      registry_mtx;
+frame_counters* registry_head = nullptr;
+
+template <typename Limits, typename T>
+std::size_t bucket_of(const Limits& limits, T value, bool inclusive) noexcept {
+    auto it = inclusive ? std::lower_bound(limits.begin(), limits.end(), value)
+                        : std::upper_bound(limits.begin(), limits.end(), value);
+    return static_cast<std::size_t>(it - limits.begin());
+}
+
+template <typename Limits>
+std::string histogram_string(const frame_stats::histogram& hist,
+                             const Limits&               limits,
+                             const char*                 bound,
+                             auto&&                      label) {
+    std::string ret;
+    for (std::size_t i = 0; i < hist.size(); ++i) {
+        if (hist[i] == 0) {
+            continue;
+        }
+        if (not ret.empty()) {
+            ret += ", ";
+        }
+        if (i < limits.size()) {
+            ret += bound;
+            ret += label(limits[i]);
+        } else {
+            ret += ">";
+            ret += label(limits.back());
+        }
+        ret += ": ";
+        ret += std::to_string(hist[i]);
+    }
+    return ret;
+}
+
+std::string size_label(std::size_t n) { return std::to_string(n) + "B"; }
+
+std::string lifetime_label(std::int64_t ns) {
+    if (ns >= 1'000'000'000) {
+        return std::to_string(ns / 1'000'000'000) + "s";
+    } else if (ns >= 1'000'000) {
+        return std::to_string(ns / 1'000'000) + "ms";
+    } else if (ns >= 1'000) {
+        return std::to_string(ns / 1'000) + "us";
+    }
+    return std::to_string(ns) + "ns";
+}
+
+frame_stats snapshot(const frame_counters& c) noexcept {
+    frame_stats ret;
+    ret.kind          = c.kind;
+    ret.allocations   = c.allocations.load(std::memory_order_relaxed);
+    ret.deallocations = c.deallocations.load(std::memory_order_relaxed);
+    ret.live          = c.live.load(std::memory_order_relaxed);
+    ret.peak_live     = c.peak_live.load(std::memory_order_relaxed);
+    ret.total_bytes   = c.total_bytes.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < frame_alloc_detail::n_stat_buckets; ++i) {
+        ret.size_histogram[i]     = c.size_histogram[i].load(std::memory_order_relaxed);
+        ret.lifetime_histogram[i] = c.lifetime_histogram[i].load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+}  // namespace
+
+// See frame_alloc.hpp. Only the one for the mode of this build is defined.
+#if NEO_FeatureIsEnabled(Neo, CoroFrameStats)
+const int frame_alloc_detail::coro_frame_stats_enabled = 1;
+#else
+const int frame_alloc_detail::coro_frame_stats_disabled = 1;
+#endif
+
+frame_counters::frame_counters(std::string_view k) noexcept
+    : kind(k) {
+    std::scoped_lock lk{registry_mtx};
+    next          = registry_head;
+    registry_head = this;
+}
+
+void frame_counters::on_allocate(std::size_t size) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    total_bytes.fetch_add(size, std::memory_order_relaxed);
+    size_histogram[bucket_of(frame_stats::size_bucket_limits, size, true)].fetch_add(
+        1,
+        std::memory_order_relaxed);
+    const auto n_live = live.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto       peak   = peak_live.load(std::memory_order_relaxed);
+    while (peak < n_live
+           and not peak_live.compare_exchange_weak(peak, n_live, std::memory_order_relaxed)) {
+    }
+}
+
+void frame_counters::on_deallocate(std::int64_t lifetime_ns) noexcept {
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    live.fetch_sub(1, std::memory_order_relaxed);
+    lifetime_histogram[bucket_of(frame_stats::lifetime_bucket_limits, lifetime_ns, false)]
+        .fetch_add(1, std::memory_order_relaxed);
+}
+
+std::int64_t frame_alloc_detail::frame_clock_now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string frame_stats::size_histogram_string() const {
+    return histogram_string(size_histogram, size_bucket_limits, "<=", size_label);
+}
+
+std::string frame_stats::lifetime_histogram_string() const {
+    return histogram_string(lifetime_histogram, lifetime_bucket_limits, "<", lifetime_label);
+}
+
+std::vector<frame_stats> neo::coroutine_frame_stats() {
+    std::vector<frame_stats> ret;
+    {
+        std::scoped_lock lk{registry_mtx};
+        for (auto c = registry_head; c; c = c->next) {
+            ret.push_back(snapshot(*c));
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](auto& a, auto& b) { return a.kind < b.kind; });
+    return ret;
+}
+
+frame_stats neo::coroutine_frame_stats(std::string_view kind) {
+    std::scoped_lock lk{registry_mtx};
+    for (auto c = registry_head; c; c = c->next) {
+        if (c->kind == kind) {
+            return snapshot(*c);
+        }
+    }
+    frame_stats ret;
+    ret.kind = kind;
+    return ret;
+}
+
+void neo::reset_coroutine_frame_stats() noexcept {
+    std::scoped_lock lk{registry_mtx};
+    for (auto c = registry_head; c; c = c->next) {
+        c->allocations.store(0, std::memory_order_relaxed);
+        c->deallocations.store(0, std::memory_order_relaxed);
+        c->total_bytes.store(0, std::memory_order_relaxed);
+        c->peak_live.store(c->live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (auto& n : c->size_histogram) {
+            n.store(0, std::memory_order_relaxed);
+        }
+        for (auto& n : c->lifetime_histogram) {
+            n.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "./frame_alloc.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neo {
+
+/**
+ * @brief Whether coroutine frame statistics are being recorded.
+ *
+ * Statistics are opt-in: Define `Neo_ToggleFeature_CoroFrameStats` to `Enabled` in
+ * `<neo-tweaks.hpp>` to have the coroutine types of neo-fun allocate their frames through
+ * `counted_frame_alloc_promise_base`. The setting changes the promise types of neo-fun, so it
+ * must be the same for the library and for every translation unit of the program. A program
+ * that mixes the two fails to link.
+ */
+constexpr bool coroutine_frame_stats_enabled = NEO_FeatureIsEnabled(Neo, CoroFrameStats);
+
+/**
+ * @brief A snapshot of the frame statistics for one kind of coroutine, such as `neo::channel`.
+ *
+ * All instantiations of a coroutine class template share the same statistics.
+ */
+struct frame_stats {
+    /// The upper bounds (inclusive) of the frame size buckets, in bytes. The last bucket
+    /// has no upper bound.
+    static constexpr std::array<std::size_t, frame_alloc_detail::n_stat_buckets - 1>
+        size_bucket_limits = {64, 128, 256, 512, 1024, 2048, 4096, 8192};
+    /// The upper bounds (exclusive) of the frame lifetime buckets, in nanoseconds. The last
+    /// bucket has no upper bound.
+    static constexpr std::array<std::int64_t, frame_alloc_detail::n_stat_buckets - 1>
+        lifetime_bucket_limits = {100,
+                                  1'000,
+                                  10'000,
+                                  100'000,
+                                  1'000'000,
+                                  10'000'000,
+                                  100'000'000,
+                                  1'000'000'000};
+
+    using histogram = std::array<std::uint64_t, frame_alloc_detail::n_stat_buckets>;
+
+    /// The name of the kind of coroutine
+    std::string_view kind;
+    /// The number of frames allocated
+    std::uint64_t allocations = 0;
+    /// The number of frames deallocated
+    std::uint64_t deallocations = 0;
+    /// The number of frames that are currently alive
+    std::uint64_t live = 0;
+    /// The largest number of frames that have been alive at once
+    std::uint64_t peak_live = 0;
+    /// The total size of the frames allocated, in bytes
+    std::uint64_t total_bytes = 0;
+    /// The number of frames allocated in each size bucket
+    histogram size_histogram = {};
+    /// The number of frames deallocated in each lifetime bucket
+    histogram lifetime_histogram = {};
+
+    /// Render the nonzero buckets of the histograms
+    std::string size_histogram_string() const;
+    std::string lifetime_histogram_string() const;
+
+    friend void do_repr(auto out, const frame_stats* self) {
+        out.type("neo::frame_stats");
+        if (self) {
+            out.bracket_value("kind={}, allocations={}, live={}, peak_live={}, total_bytes={}, "
+                              "sizes=[{}], lifetimes=[{}]",
+                              out.repr_value(self->kind),
+                              self->allocations,
+                              self->live,
+                              self->peak_live,
+                              self->total_bytes,
+                              self->size_histogram_string(),
+                              self->lifetime_histogram_string());
+        }
+    }
+};
+
+/**
+ * @brief Get the frame statistics of each kind of coroutine that has allocated a frame.
+ *
+ * The result is ordered by `kind`. It is always empty unless `coroutine_frame_stats_enabled`.
+ */
+std::vector<frame_stats> coroutine_frame_stats();
+
+/**
+ * @brief Get the frame statistics of one kind of coroutine, e.g. "neo::generator".
+ *
+ * If no frame of that kind has been allocated, returns an empty `frame_stats`.
+ */
+frame_stats coroutine_frame_stats(std::string_view kind);
+
+/**
+ * @brief Reset the counts and histograms of every kind of coroutine. The live count of frames
+ * is kept, and becomes the peak live count.
+ */
+void reset_coroutine_frame_stats() noexcept;
+
+}  // namespace neo
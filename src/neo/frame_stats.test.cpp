@@ -0,0 +1,121 @@
+#include "./frame_stats.hpp"
+
+#include "./channel.hpp"
+#include "./generator.hpp"
+#include "./immediate.hpp"
+#include "./repr.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#if NEO_FeatureIsEnabled(Neo, CoroFrameStats)
+
+namespace {
+
+neo::generator<int> count_to(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+neo::channel<int, void, int> sum_of_counts(int n) {
+    int total = 0;
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+        total += i;
+    }
+    co_return total;
+}
+
+neo::immediate<int> immediate_sum(int a, int b) { co_return a + b; }
+
+std::uint64_t histogram_total(const neo::frame_stats::histogram& h) {
+    return std::accumulate(h.begin(), h.end(), std::uint64_t(0));
+}
+
+}  // namespace
+
+TEST_CASE("Count generator frames") {
+    neo::reset_coroutine_frame_stats();
+    auto before = neo::coroutine_frame_stats("neo::generator");
+    {
+        std::vector<neo::generator<int>> gens;
+        for (int i = 0; i < 5; ++i) {
+            gens.push_back(count_to(3));
+        }
+        auto during = neo::coroutine_frame_stats("neo::generator");
+        CHECK(during.kind == "neo::generator");
+        CHECK(during.allocations == before.allocations + 5);
+        CHECK(during.live == before.live + 5);
+        CHECK(during.peak_live >= during.live);
+        CHECK(during.total_bytes > before.total_bytes);
+        CHECK(histogram_total(during.size_histogram) == during.allocations);
+        for (auto& g : gens) {
+            int sum = 0;
+            for (auto n : g) {
+                sum += n;
+            }
+            CHECK(sum == 3);
+        }
+    }
+    auto after = neo::coroutine_frame_stats("neo::generator");
+    CHECK(after.live == before.live);
+    CHECK(after.deallocations == before.deallocations + 5);
+    CHECK(after.peak_live >= before.live + 5);
+    CHECK(histogram_total(after.lifetime_histogram) == after.deallocations);
+}
+
+TEST_CASE("Count channel and immediate frames separately") {
+    neo::reset_coroutine_frame_stats();
+    auto chan_before = neo::coroutine_frame_stats("neo::channel");
+    auto imm_before  = neo::coroutine_frame_stats("neo::immediate");
+    {
+        auto ch = sum_of_counts(4);
+        auto io = ch.open();
+        while (not io.done()) {
+            io.send();
+        }
+        CHECK(io.return_value() == 6);
+        CHECK(neo::coroutine_frame_stats("neo::channel").live == chan_before.live + 1);
+    }
+    CHECK(neo::coroutine_frame_stats("neo::channel").allocations == chan_before.allocations + 1);
+    CHECK(neo::coroutine_frame_stats("neo::channel").live == chan_before.live);
+    // An immediate coroutine allocates a frame, but a ready value does not
+    CHECK(*immediate_sum(2, 3) == 5);
+    CHECK(*neo::make_immediate(5) == 5);
+    CHECK(neo::coroutine_frame_stats("neo::immediate").allocations == imm_before.allocations + 1);
+
+    auto all = neo::coroutine_frame_stats();
+    CHECK(std::ranges::is_sorted(all, std::less<>{}, &neo::frame_stats::kind));
+    CHECK(std::ranges::count(all, "neo::channel", &neo::frame_stats::kind) == 1);
+}
+
+TEST_CASE("Reset frame statistics") {
+    auto g = count_to(2);
+    neo::reset_coroutine_frame_stats();
+    auto stats = neo::coroutine_frame_stats("neo::generator");
+    CHECK(stats.allocations == 0);
+    CHECK(stats.total_bytes == 0);
+    CHECK(stats.live >= 1);
+    CHECK(stats.peak_live == stats.live);
+}
+
+TEST_CASE("repr() of frame statistics") {
+    auto g    = count_to(2);
+    auto repr = neo::repr(neo::coroutine_frame_stats("neo::generator")).string();
+    CHECK_THAT(repr, Catch::Contains("neo::frame_stats"));
+    CHECK_THAT(repr, Catch::Contains("neo::generator"));
+    CHECK_THAT(repr, Catch::Contains("live="));
+}
+
+#endif
+
+TEST_CASE("Unknown kinds have no frame statistics") {
+    auto stats = neo::coroutine_frame_stats("no-such-coroutine");
+    CHECK(stats.allocations == 0);
+    CHECK(stats.live == 0);
+}
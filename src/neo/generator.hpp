@@ -2,16 +2,48 @@
 
 #include "./addressof.hpp"
 #include "./concepts.hpp"
+#include "./coro_stop.hpp"
+#include "./frame_alloc.hpp"
+#include "./fwd.hpp"
 #include "./iterator_concepts.hpp"
 
 #include <coroutine>
+#include <ranges>
 #include <stdexcept>
 
 namespace neo {
 
+/**
+ * @brief Wrap a range to be yielded element-by-element from a generator.
+ *
+ * Within a `generator<T>` coroutine, `co_yield elements_of(r)` yields each element
+ * of `r` in turn. If `r` is a `generator<T>` of the same type, the nested generator
+ * is resumed directly by whoever is iterating the outermost generator, so yielding
+ * from a deeply nested generator does not need to pass through every level.
+ *
+ * The range is held by reference. It must live until the `co_yield` completes,
+ * which is always the case for a temporary in the `co_yield` expression.
+ */
+template <typename R>
+struct elements_of {
+    R&& range;
+};
+
+template <typename R>
+elements_of(R&&) -> elements_of<R>;
+
 /**
  * @brief A coroutine type that yields values sequentially from an arbitrary computation.
  *
+ * Generators may delegate to other generators using `co_yield elements_of(...)`.
+ *
+ * Iteration may be cancelled with `request_stop()` or `attach_stop_token()`. Generator
+ * coroutines may poll for a stop using `co_await neo::this_stop_token`.
+ *
+ * The coroutine frame is allocated using `frame_alloc_promise_base`, so a generator
+ * may accept a leading `std::allocator_arg_t, Alloc` pair of parameters. Otherwise,
+ * frames are reused from the thread's frame recycler.
+ *
  * @tparam YieldType The type of objects that will be generated
  */
 template <typename T>
@@ -19,59 +51,196 @@ class [[nodiscard]] generator {
 public:
     using yield_type = T;
 
-    class promise_type {
+    class promise_type : public frame_alloc_promise_base_for<"neo::generator"> {
     public:
         using reference_type = yield_type&;
         using pointer_type   = add_pointer_t<reference_type>;
         using value_type     = remove_cvref_t<yield_type>;
 
     private:
+        using handle_type = std::coroutine_handle<promise_type>;
+
         std::exception_ptr    _exc     = nullptr;
         pointer_type          _current = nullptr;
         constexpr static bool is_ref   = neo_is_reference(yield_type);
 
+        /**
+         * @brief The promise of the outermost generator in the current stack of nested
+         * generators. Values are yielded directly into the root's `_current`.
+         */
+        promise_type* _root = this;
+        /**
+         * @brief The innermost active generator in the stack. Only meaningful on the root. This
+         * is the coroutine that is resumed to produce the next value.
+         */
+        handle_type _leaf = nullptr;
+        /// The generator that is yielding our elements, or null if we are the root.
+        handle_type _parent = nullptr;
+        /// The stop state of the generator stack. Only meaningful on the root.
+        coro_stop_detail::stop_state _stop;
+
+        friend generator;
+
         using lref  = value_type&;
         using rref  = value_type&&;
         using clref = value_type const&;
 
+        // Used at the end of a generator to resume the parent generator, if present.
+        struct final_awaiter {
+            constexpr bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle_type co) const noexcept {
+                auto& self = co.promise();
+                if (self._parent) {
+                    // Symmetric transfer back to the parent, which becomes the new leaf
+                    self._root->_leaf = self._parent;
+                    return self._parent;
+                }
+                return std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        // Awaiter generated by `co_yield` of a value. If a stop was requested, the value is not
+        // published and the `co_yield` throws.
+        struct yield_awaiter {
+            promise_type& root;
+
+            bool await_ready() const noexcept { return root._stop.stop_requested(); }
+            constexpr void await_suspend(std::coroutine_handle<>) const noexcept {}
+            void           await_resume() const { root._stop.throw_if_stop_requested(); }
+        };
+
+        // Awaiter generated by `co_yield elements_of(gen)`
+        template <typename Gen>
+        struct nested_awaiter {
+            Gen gen;
+
+            promise_type& root;
+
+            bool await_ready() const noexcept {
+                // An exhausted generator is suspended at its final suspend point, and must not
+                // be resumed
+                return not gen._coro or gen._coro.done() or root._stop.stop_requested();
+            }
+
+            std::coroutine_handle<> await_suspend(handle_type parent) const noexcept {
+                auto& child = gen._coro.promise();
+                auto& root  = *parent.promise()._root;
+                child._root   = &root;
+                child._parent = parent;
+                root._leaf    = gen._coro;
+                // Begin executing the nested generator
+                return gen._coro;
+            }
+
+            void await_resume() const {
+                if (gen._coro) {
+                    gen._coro.promise().throw_if_exc();
+                }
+                root._stop.throw_if_stop_requested();
+            }
+        };
+
+        // Yields the elements of an arbitrary range
+        template <typename R>
+        static generator _yield_all(R&& r) {
+            for (auto&& el : r) {
+                co_yield NEO_FWD(el);
+            }
+        }
+
     public:
         generator<yield_type> get_return_object() noexcept;
 
         constexpr auto initial_suspend() const noexcept { return std::suspend_always{}; }
-        constexpr auto final_suspend() const noexcept { return std::suspend_always{}; }
+        constexpr auto final_suspend() const noexcept { return final_awaiter{}; }
 
         constexpr auto yield_value(lref v) noexcept
             requires constructible_from<T, lref>
         {
-            _current = NEO_ADDRESSOF(v);
-            return std::suspend_always{};
+            _root->_current = NEO_ADDRESSOF(v);
+            return yield_awaiter{*_root};
         }
 
         constexpr auto yield_value(clref v) noexcept
+            requires constructible_from<T, clref> and convertible_to<const value_type*, pointer_type>
+        {
+            _root->_current = NEO_ADDRESSOF(v);
+            return yield_awaiter{*_root};
+        }
+
+        /**
+         * @brief Yield a copy of a const object. Used if the yield type is not a
+         * reference-to-const, since the consumer may modify or move from the yielded object.
+         */
+        constexpr auto yield_value(clref v) noexcept(nothrow_constructible_from<value_type, clref>)
             requires constructible_from<T, clref>
+            and (not convertible_to<const value_type*, pointer_type>)
         {
-            _current = NEO_ADDRESSOF(v);
-            return std::suspend_always{};
+            struct copy_awaiter {
+                promise_type& self;
+                value_type    copy;
+
+                bool await_ready() const noexcept { return self._root->_stop.stop_requested(); }
+                constexpr void await_suspend(std::coroutine_handle<>) noexcept {
+                    self._root->_current = NEO_ADDRESSOF(copy);
+                }
+                void await_resume() const { self._root->_stop.throw_if_stop_requested(); }
+            };
+            return copy_awaiter{*this, value_type(v)};
         }
 
         constexpr auto yield_value(rref v) noexcept
             requires constructible_from<T, rref>
         {
-            _current = NEO_ADDRESSOF(v);
-            return std::suspend_always{};
+            _root->_current = NEO_ADDRESSOF(v);
+            return yield_awaiter{*_root};
         }
 
-        constexpr void unhandled_exception() noexcept { _exc = std::current_exception(); }
+        /**
+         * @brief Yield each element of another generator of the same type. The nested
+         * generator becomes the leaf of the generator stack until it completes.
+         */
+        template <typename G>
+            requires same_as<remove_cvref_t<G>, generator>
+        auto yield_value(elements_of<G> e) noexcept {
+            return nested_awaiter<generator&>{e.range, *_root};
+        }
+
+        /**
+         * @brief Yield each element of an arbitrary range.
+         */
+        template <std::ranges::input_range R>
+            requires(not same_as<remove_cvref_t<R>, generator>)
+            and convertible_to<std::ranges::range_reference_t<R>, T>
+        auto yield_value(elements_of<R> e) {
+            return nested_awaiter<generator>{_yield_all(NEO_FWD(e.range)), *_root};
+        }
+
+        // If we are a nested generator, the exception will be rethrown from the `co_yield`
+        // expression in the parent. If the stack was unwound by a stop request, the root
+        // finishes quietly.
+        void unhandled_exception() noexcept {
+            if (_root == this and _stop.is_cancellation()) {
+                return;
+            }
+            _exc = std::current_exception();
+        }
 
         constexpr void return_void() noexcept {}
 
-        // Disable 'co_await' inside of a generator (We aren't an async generator)
+        // Disable 'co_await' inside of a generator (See neo::async_generator for that)
         template <typename Other>
         [[deprecated("You cannot use 'co_await' inside a generator")]]  //
         std::suspend_never
         await_transform(Other&&)
             = delete;
 
+        /// ...except for `co_await neo::this_stop_token`
+        auto await_transform(this_stop_token_t) {
+            return coro_stop_detail::stop_state::token_awaiter{_root->_stop.get_token()};
+        }
+
         constexpr reference_type get_value() const noexcept { return *_current; }
 
         void throw_if_exc() const {
@@ -112,7 +281,7 @@ public:
             return static_cast<reference>(_coro.promise().get_value());
         }
         constexpr iterator& operator++() {
-            _coro.resume();
+            _coro.promise()._leaf.resume();
             if (_coro.done()) {
                 _coro.promise().throw_if_exc();
             }
@@ -160,7 +329,7 @@ public:
      */
     [[nodiscard]] constexpr input_iterator auto begin() {
         if (_coro) {
-            _coro.resume();
+            _coro.promise()._leaf.resume();
             if (_coro.done()) {
                 _coro.promise().throw_if_exc();
             }
@@ -168,13 +337,34 @@ public:
         return iterator{_coro};
     }
 
+    /**
+     * @brief Request that the generator stop.
+     *
+     * The next time the generator is resumed, the `co_yield` in the innermost generator
+     * throws `neo::coroutine_cancelled` instead of producing another value. The exception
+     * unwinds the nested generators, and iteration ends.
+     */
+    void request_stop() noexcept {
+        if (_coro) {
+            _coro.promise()._stop.request_stop();
+        }
+    }
+
+    /// Request a stop of the generator when the given token is signalled
+    void attach_stop_token(std::stop_token tok) {
+        if (_coro) {
+            _coro.promise()._stop.attach(NEO_MOVE(tok));
+        }
+    }
+
     /// Obtain a sentinel indicating completion of the generator
     [[nodiscard]] constexpr auto end() const noexcept { return typename iterator::sentinel_type{}; }
 };
 
 template <typename T>
 generator<T> generator<T>::promise_type::get_return_object() noexcept {
-    return generator<T>{std::coroutine_handle<generator<T>::promise_type>::from_promise(*this)};
+    _leaf = handle_type::from_promise(*this);
+    return generator<T>{_leaf};
 }
 
 }  // namespace neo
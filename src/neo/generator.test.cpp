@@ -3,6 +3,7 @@
 #include "./generator.hpp"
 
 #include "./ranges.hpp"
+#include "./testing.hpp"
 
 #include <catch2/catch.hpp>
 
@@ -90,4 +91,174 @@ TEST_CASE("Yield move-only objects") {
     CHECK(it == g.end());
 }
 
-#endif
\ No newline at end of file
+neo::generator<int> count_up(int from, int to) {
+    for (int i = from; i < to; ++i) {
+        co_yield i;
+    }
+}
+
+neo::generator<int> nested_counts() {
+    co_yield 0;
+    co_yield neo::elements_of(count_up(1, 4));
+    auto more = count_up(4, 6);
+    co_yield neo::elements_of(more);
+    co_yield 6;
+}
+
+TEST_CASE("Yield the elements of another generator") {
+    auto vec = neo::to_vector(nested_counts());
+    CHECK(vec == std::vector<int>({0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST_CASE("Yield the elements of an exhausted generator") {
+    auto used = count_up(0, 2);
+    CHECK(neo::to_vector(used) == std::vector<int>({0, 1}));
+    auto outer = [&]() -> neo::generator<int> {
+        co_yield 7;
+        co_yield neo::elements_of(used);
+        co_yield 8;
+    };
+    CHECK(neo::to_vector(outer()) == std::vector<int>({7, 8}));
+}
+
+neo::generator<std::string> strings_from(const std::vector<std::string>& strings) {
+    co_yield "first";
+    co_yield neo::elements_of(strings);
+    std::vector<const char*> cstrings = {"baz", "quux"};
+    co_yield neo::elements_of(cstrings);
+}
+
+TEST_CASE("Yield the elements of a range") {
+    auto vec = neo::to_vector(strings_from({"foo", "bar"}));
+    CHECK(vec == std::vector<std::string>({"first", "foo", "bar", "baz", "quux"}));
+}
+
+struct tree {
+    int               value;
+    std::vector<tree> children;
+};
+
+neo::generator<const int&> walk(const tree& t) {
+    co_yield t.value;
+    for (auto& child : t.children) {
+        co_yield neo::elements_of(walk(child));
+    }
+}
+
+TEST_CASE("Recursive generator") {
+    tree t{1, {{2, {{3, {}}, {4, {}}}}, {5, {}}, {6, {{7, {{8, {}}}}}}}};
+    auto vec = neo::to_vector(walk(t));
+    CHECK(vec == std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+neo::generator<int> deep(int n) {
+    if (n == 0) {
+        co_yield 42;
+        co_yield 1729;
+    } else {
+        co_yield neo::elements_of(deep(n - 1));
+    }
+}
+
+TEST_CASE("Deeply nested generator") {
+    auto vec = neo::to_vector(deep(10'000));
+    CHECK(vec == std::vector<int>({42, 1729}));
+}
+
+neo::generator<int> nested_throws() {
+    co_yield 1;
+    throw std::runtime_error("nested");
+}
+
+neo::generator<int> catches_nested() {
+    bool caught = false;
+    try {
+        co_yield neo::elements_of(nested_throws());
+        FAIL("Nested generator did not throw");
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (caught) {
+        co_yield 2;
+    }
+    co_yield neo::elements_of(nested_throws());
+}
+
+TEST_CASE("Exceptions from nested generators") {
+    auto gen = catches_nested();
+    auto it  = gen.begin();
+    CHECK(*it == 1);
+    ++it;
+    CHECK(*it == 2);
+    ++it;
+    CHECK(*it == 1);
+    CHECK_THROWS_AS(++it, std::runtime_error);
+    CHECK(it == gen.end());
+}
+
+using neo::testing::alloc_stats;
+using neo::testing::counting_allocator;
+
+neo::generator<const int&> walk_alloc(std::allocator_arg_t, counting_allocator<int> alloc,
+                                      const tree& t) {
+    co_yield t.value;
+    for (auto& child : t.children) {
+        co_yield neo::elements_of(walk_alloc(std::allocator_arg, alloc, child));
+    }
+}
+
+TEST_CASE("Generator with an allocator") {
+    tree                    t{1, {{2, {}}, {3, {}}}};
+    alloc_stats             stats;
+    counting_allocator<int> alloc{stats};
+    auto                    vec = neo::to_vector(walk_alloc(std::allocator_arg, alloc, t));
+    CHECK(vec == std::vector<int>({1, 2, 3}));
+    CHECK(stats.n_allocs == 3);
+    CHECK(stats.n_deallocs == 3);
+}
+
+TEST_CASE("Stop a nested generator") {
+    int  n_produced = 0;
+    auto inner      = [&]() -> neo::generator<int> {
+        for (int i = 0;; ++i) {
+            ++n_produced;
+            co_yield i;
+        }
+    };
+    auto outer = [&]() -> neo::generator<int> {
+        co_yield 100;
+        co_yield neo::elements_of(inner());
+    };
+    auto             gen = outer();
+    std::vector<int> got;
+    for (int v : gen) {
+        got.push_back(v);
+        if (got.size() == 4) {
+            gen.request_stop();
+        }
+    }
+    CHECK(got == std::vector<int>({100, 0, 1, 2}));
+    CHECK(n_produced == 3);
+}
+
+TEST_CASE("Poll for a stop in a generator") {
+    std::stop_source src;
+    auto             naturals = []() -> neo::generator<int> {
+        auto tok = co_await neo::this_stop_token;
+        for (int i = 0; not tok.stop_requested(); ++i) {
+            co_yield i;
+        }
+    };
+    auto gen = naturals();
+    gen.attach_stop_token(src.get_token());
+    int sum = 0;
+    for (int v : gen) {
+        sum += v;
+        if (v == 9) {
+            src.request_stop();
+        }
+    }
+    CHECK(sum == 45);
+}
+
+#endif
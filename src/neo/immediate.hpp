@@ -2,9 +2,12 @@
 
 #include "./addressof.hpp"
 #include "./assert.hpp"
+#include "./concepts.hpp"
+#include "./frame_alloc.hpp"
 #include "./fwd.hpp"
 #include "./optional.hpp"
 #include "./type_traits.hpp"
+#include "./unit.hpp"
 #include "neo/attrib.hpp"
 
 #include <coroutine>
@@ -24,13 +27,16 @@ class immediate;
 /**
  * @brief Create an `immediate<T>` that is immediately ready with a value
  *
+ * The value is stored inline in the immediate, without allocating a coroutine frame.
+ *
  * @tparam T The result type of the immediate
  * @param value The value
  * @return immediate<remove_cvref_t<T>>
  */
 template <typename T>
-immediate<remove_cvref_t<T>> make_immediate(T&& value) noexcept {
-    co_return NEO_FWD(value);
+immediate<remove_cvref_t<T>>
+make_immediate(T&& value) noexcept(nothrow_constructible_from<remove_cvref_t<T>, T>) {
+    return immediate<remove_cvref_t<T>>(std::in_place, NEO_FWD(value));
 }
 
 inline immediate<void> make_immediate() noexcept;
@@ -47,7 +53,7 @@ struct defer_convert {
     constexpr operator immediate<T>() const noexcept;
 };
 
-struct immediate_promise_base {
+struct immediate_promise_base : frame_alloc_promise_base_for<"neo::immediate"> {
     auto initial_suspend() const noexcept { return std::suspend_never{}; }
     auto final_suspend() const noexcept { return std::suspend_always{}; }
     auto unhandled_exception() { throw; }
@@ -81,6 +87,11 @@ struct immediate_promise<void> : immediate_promise_base {
 /**
  * @brief A coroutine return type that never suspends and runs to completion immediately.
  *
+ * An immediate is either the result of a coroutine, in which case the value lives in the
+ * (completed) coroutine frame, or a ready value that is stored inline, which is created by
+ * `make_immediate()` or by constructing an immediate from a value. Returning a ready value
+ * from a non-coroutine function does not allocate.
+ *
  * @tparam T The result type of the coroutine (the co_return type)
  */
 template <typename T>
@@ -93,7 +104,8 @@ public:
 
     template <typename Ref>
     struct awaiter {
-        co_type _co;
+        // Points to the value. Unused for `void`
+        add_pointer_t<remove_reference_t<Ref>> _value;
 
         constexpr bool await_ready() noexcept { return true; }
 
@@ -102,7 +114,7 @@ public:
             if constexpr (neo_is_void(T)) {
                 // No data to return
             } else {
-                return static_cast<Ref&&>(_co.promise().value());
+                return static_cast<Ref&&>(*_value);
             }
         }
     };
@@ -110,38 +122,69 @@ public:
 private:
     constexpr static bool is_void = neo_is_void(T);
     using NonVoid                 = conditional_t<is_void, decltype(nullptr), T>;
-    co_type _co;
+    // The coroutine that produced the value, or null if the value is stored inline
+    co_type _co = nullptr;
+    // The inline value, if we did not come from a coroutine. (Always empty for `void`)
+    NEO_NO_UNIQUE_ADDRESS conditional_t<is_void, unit, optional<NonVoid>> _ready;
+
+    NonVoid& _value() noexcept
+        requires(not is_void)
+    {
+        return _co ? _co.promise().value() : *_ready;
+    }
 
-    NonVoid& _value() const noexcept
+    const NonVoid& _value() const noexcept
         requires(not is_void)
     {
-        return _co.promise().value();
+        return _co ? _co.promise().value() : *_ready;
+    }
+
+    template <typename Ref, typename Self>
+    static awaiter<Ref> _awaiter(Self& self) noexcept {
+        if constexpr (is_void) {
+            return {nullptr};
+        } else {
+            return {NEO_ADDRESSOF(self._value())};
+        }
     }
 
 public:
     explicit immediate(co_type co) noexcept
         : _co(co) {}
 
-    immediate(immediate&& o) noexcept
-        : _co(o._co) {
-        o._co = nullptr;
-    }
+    immediate(immediate&& o) noexcept(is_void or nothrow_constructible_from<NonVoid, NonVoid&&>)
+        : _co(std::exchange(o._co, nullptr))
+        , _ready(NEO_MOVE(o._ready)) {}
 
-    immediate& operator=(immediate&& o) noexcept {
+    immediate&
+    operator=(immediate&& o) noexcept(is_void or std::is_nothrow_move_assignable_v<NonVoid>) {
         if (_co) {
             _co.destroy();
         }
-        _co   = o._co;
-        o._co = nullptr;
+        _co    = std::exchange(o._co, nullptr);
+        _ready = NEO_MOVE(o._ready);
         return *this;
     }
 
-    immediate(NonVoid&& init) noexcept
-        : immediate(make_immediate(NEO_FWD(init))) {}
+    /// Create an immediate that holds the given value inline
+    immediate(NonVoid&& init) noexcept(nothrow_constructible_from<NonVoid, NonVoid&&>)
+        requires(not is_void)
+    {
+        _ready.emplace(NEO_FWD(init));
+    }
+
+    /// Create an immediate that holds a value constructed inline from the given argument
+    template <typename U>
+    explicit immediate(std::in_place_t,
+                       U&& arg) noexcept(nothrow_constructible_from<NonVoid, U>)
+        requires(not is_void and constructible_from<NonVoid, U>)
+    {
+        _ready.emplace(NEO_FWD(arg));
+    }
 
     immediate() noexcept
         requires is_void
-        : immediate(make_immediate()) {}
+    = default;
 
     ~immediate() {
         if (_co) {
@@ -181,10 +224,10 @@ public:
         return neo::addressof(_value());
     }
 
-    auto operator co_await() & noexcept { return awaiter<NonVoid&>{_co}; }
-    auto operator co_await() const& noexcept { return awaiter<const NonVoid&>{_co}; }
-    auto operator co_await() && noexcept { return awaiter<NonVoid>{_co}; }
-    auto operator co_await() const&& noexcept { return awaiter<const NonVoid>{_co}; }
+    auto operator co_await() & noexcept { return _awaiter<NonVoid&>(*this); }
+    auto operator co_await() const& noexcept { return _awaiter<const NonVoid&>(*this); }
+    auto operator co_await() && noexcept { return _awaiter<NonVoid>(*this); }
+    auto operator co_await() const&& noexcept { return _awaiter<const NonVoid>(*this); }
 };
 
 template <typename T>
@@ -199,4 +242,4 @@ constexpr imm_detail::defer_convert<T>::operator immediate<T>() const noexcept {
 
 }  // namespace neo
 
-inline neo::immediate<void> neo::make_immediate() noexcept { co_return; }
+inline neo::immediate<void> neo::make_immediate() noexcept { return neo::immediate<void>(); }
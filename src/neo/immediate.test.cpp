@@ -6,6 +6,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
 neo::immediate<int> immediate_int() { return neo::immediate{12}; }
 
 neo::immediate<void> coro_void(bool& set_true) {
@@ -62,6 +67,79 @@ neo::immediate<void> await_uptr() {
 
 TEST_CASE("Await on a move-only") { await_uptr(); }
 
+TEST_CASE("Move a ready immediate") {
+    auto a = neo::make_immediate(std::make_unique<int>(7));
+    auto b = std::move(a);
+    CHECK(**b == 7);
+    // Assign a coroutine result over a ready value, and vice versa
+    b = get_uptr();
+    CHECK(**b == 3312);
+    b = neo::make_immediate(std::make_unique<int>(8));
+    CHECK(**b == 8);
+}
+
+TEST_CASE("Await ready immediates of each category") {
+    auto imm = neo::make_immediate(std::string("hello"));
+    [&]() -> neo::immediate<void> {
+        std::string& ref = co_await imm;
+        CHECK(ref == "hello");
+        const auto&        cimm = imm;
+        const std::string& cref = co_await cimm;
+        CHECK(&cref == &ref);
+        std::string moved = co_await std::move(imm);
+        CHECK(moved == "hello");
+        co_await neo::make_immediate();
+    }();
+}
+
+TEST_CASE("Make ready immediates from lvalues") {
+    std::string       str  = "mutable";
+    const std::string cstr = "const";
+    auto              a    = neo::make_immediate(str);
+    auto              b    = neo::make_immediate(cstr);
+    static_assert(std::same_as<decltype(a), neo::immediate<std::string>>);
+    static_assert(std::same_as<decltype(b), neo::immediate<std::string>>);
+    CHECK(*a == "mutable");
+    CHECK(*b == "const");
+    // The immediates hold copies
+    CHECK(str == "mutable");
+    CHECK(&*a != &str);
+    static_assert(noexcept(neo::make_immediate(1)));
+    static_assert(not noexcept(neo::make_immediate(str)));
+}
+
+namespace {
+
+// A cache lookup that is usually a hit
+neo::immediate<int> cached_lookup(int key) {
+    if (key % 64 != 0) {
+        return neo::make_immediate(key * 2);
+    }
+    return [](int k) -> neo::immediate<int> { co_return k * 2; }(key);
+}
+
+neo::immediate<int> lookup_coro(int key) { co_return key * 2; }
+
+}  // namespace
+
+TEST_CASE("Ready immediate throughput", "[.][benchmark]") {
+    const int n = 10'000'000;
+    auto      run = [&](const char* name, auto lookup) {
+        auto      start = std::chrono::steady_clock::now();
+        long long sum   = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += *lookup(i);
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        CHECK(sum == (n - 1LL) * n);
+        std::printf("%-12s %6.2f ns per lookup\n",
+                    name,
+                    std::chrono::duration<double, std::nano>(dur).count() / n);
+    };
+    run("coroutine", lookup_coro);
+    run("ready value", cached_lookup);
+}
+
 static_assert(neo::awaitable<neo::immediate<int>>);
 static_assert(std::same_as<int&&, neo::await_result_t<neo::immediate<int>>>);
 static_assert(std::same_as<int&, neo::await_result_t<neo::immediate<int>&>>);
@@ -0,0 +1,318 @@
+#include "./platform.hpp"
+
+#if NEO_OS_IS_LINUX
+
+#include "./io_uring.hpp"
+
+#include "./assert.hpp"
+#include "./scope.hpp"
+
+#include <linux/io_uring.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace neo;
+
+namespace {
+
+[[noreturn]] void throw_errno(int err, const char* what) {
+    throw std::system_error(err, std::system_category(), what);
+}
+
+/// A mapping of part of the io_uring into our memory
+struct mapping {
+    void*       ptr  = MAP_FAILED;
+    std::size_t size = 0;
+
+    mapping() = default;
+    mapping(int fd, std::size_t size, off_t offset)
+        : ptr(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset))
+        , size(size) {
+        if (ptr == MAP_FAILED) {
+            throw_errno(errno, "mmap() of io_uring");
+        }
+    }
+
+    mapping(mapping&& o) noexcept
+        : ptr(std::exchange(o.ptr, MAP_FAILED))
+        , size(o.size) {}
+
+    mapping& operator=(mapping&& o) noexcept {
+        std::swap(ptr, o.ptr);
+        std::swap(size, o.size);
+        return *this;
+    }
+
+    ~mapping() {
+        if (ptr != MAP_FAILED) {
+            ::munmap(ptr, size);
+        }
+    }
+
+    template <typename T>
+    T* at(std::size_t offset) const noexcept {
+        return reinterpret_cast<T*>(static_cast<char*>(ptr) + offset);
+    }
+};
+
+}  // namespace
+
+struct io_uring_context::impl {
+    int     ring_fd = -1;
+    mapping sq_map;
+    mapping cq_map;
+    mapping sqe_map;
+
+    // Submission queue. The kernel reads the head, and we write the tail.
+    unsigned*     sq_head;
+    unsigned*     sq_tail;
+    unsigned      sq_mask;
+    unsigned      sq_entries;
+    unsigned*     sq_array;
+    io_uring_sqe* sqes;
+
+    // Completion queue. The kernel writes the tail, and we write the head.
+    unsigned*     cq_head;
+    unsigned*     cq_tail;
+    unsigned      cq_mask;
+    io_uring_cqe* cqes;
+
+    // Number of requests in the submission queue that have not been given to the kernel
+    unsigned to_submit = 0;
+    // Number of requests that have not yet completed
+    std::size_t in_flight = 0;
+
+    explicit impl(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof params);
+        ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0) {
+            throw_errno(errno, "io_uring_setup()");
+        }
+
+        auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        try {
+            if (params.features & IORING_FEAT_SINGLE_MMAP) {
+                // The SQ and CQ rings share a single mapping
+                sq_map = mapping(ring_fd, std::max(sq_size, cq_size), IORING_OFF_SQ_RING);
+            } else {
+                sq_map = mapping(ring_fd, sq_size, IORING_OFF_SQ_RING);
+                cq_map = mapping(ring_fd, cq_size, IORING_OFF_CQ_RING);
+            }
+            sqe_map = mapping(ring_fd, params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES);
+        } catch (...) {
+            // Our destructor will not run
+            ::close(ring_fd);
+            throw;
+        }
+        const mapping& cq = cq_map.ptr == MAP_FAILED ? sq_map : cq_map;
+
+        sq_head    = sq_map.at<unsigned>(params.sq_off.head);
+        sq_tail    = sq_map.at<unsigned>(params.sq_off.tail);
+        sq_mask    = *sq_map.at<unsigned>(params.sq_off.ring_mask);
+        sq_entries = *sq_map.at<unsigned>(params.sq_off.ring_entries);
+        sq_array   = sq_map.at<unsigned>(params.sq_off.array);
+        sqes       = sqe_map.at<io_uring_sqe>(0);
+
+        cq_head = cq.at<unsigned>(params.cq_off.head);
+        cq_tail = cq.at<unsigned>(params.cq_off.tail);
+        cq_mask = *cq.at<unsigned>(params.cq_off.ring_mask);
+        cqes    = cq.at<io_uring_cqe>(params.cq_off.cqes);
+    }
+
+    ~impl() {
+        neo_assert(expects,
+                   in_flight == 0,
+                   "An io_uring_context was destroyed while operations were still in flight",
+                   in_flight);
+        ::close(ring_fd);
+    }
+
+    /// Give all queued requests to the kernel, optionally waiting for completions
+    void enter(unsigned min_complete) {
+        unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+        while (to_submit != 0 or min_complete != 0) {
+            auto n = ::syscall(__NR_io_uring_enter,
+                               ring_fd,
+                               to_submit,
+                               min_complete,
+                               flags,
+                               nullptr,
+                               0);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EBUSY or errno == EAGAIN) {
+                    // The completion queue is full, or the kernel is out of resources. The
+                    // caller must reap some completions before we can submit more.
+                    return;
+                }
+                throw_errno(errno, "io_uring_enter()");
+            }
+            to_submit -= static_cast<unsigned>(n);
+            min_complete = 0;
+            flags        = 0;
+        }
+    }
+
+    /// Obtain a free submission queue entry, submitting queued requests if the queue is full
+    io_uring_sqe& next_sqe() {
+        const auto tail = *sq_tail;
+        auto       head = std::atomic_ref<unsigned>(*sq_head).load(std::memory_order_acquire);
+        while (tail - head == sq_entries) {
+            enter(0);
+            if (tail - std::atomic_ref<unsigned>(*sq_head).load(std::memory_order_acquire)
+                == sq_entries) {
+                // The kernel could not accept anything. Make room by reaping completions.
+                reap();
+            }
+            head = std::atomic_ref<unsigned>(*sq_head).load(std::memory_order_acquire);
+        }
+        const auto idx = tail & sq_mask;
+        auto&      sqe = sqes[idx];
+        std::memset(&sqe, 0, sizeof sqe);
+        sq_array[idx] = idx;
+        return sqe;
+    }
+
+    /// Make the entry most-recently obtained by next_sqe() visible to the kernel
+    void push_sqe() noexcept {
+        std::atomic_ref<unsigned>(*sq_tail).store(*sq_tail + 1, std::memory_order_release);
+        ++to_submit;
+        ++in_flight;
+    }
+
+    /// Resume the coroutines of all completed requests
+    std::size_t reap() {
+        std::size_t n_resumed = 0;
+        for (;;) {
+            // Re-read the head each time, since a resumed coroutine may reap recursively
+            auto head = *cq_head;
+            if (head == std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire)) {
+                break;
+            }
+            const auto& cqe = cqes[head & cq_mask];
+            auto        op  = reinterpret_cast<operation*>(cqe.user_data);
+            op->_result     = cqe.res;
+            // Release the entry before resuming, since the coroutine may queue more requests
+            std::atomic_ref<unsigned>(*cq_head).store(++head, std::memory_order_release);
+            --in_flight;
+            ++n_resumed;
+            op->_co.resume();
+        }
+        return n_resumed;
+    }
+};
+
+io_uring_context::io_uring_context(unsigned entries)
+    : _impl(std::make_unique<impl>(entries)) {}
+
+io_uring_context::~io_uring_context() = default;
+
+io_uring_context::operation::operation(io_uring_context& ctx,
+                                       std::uint8_t      opcode,
+                                       int               fd,
+                                       void*             addr,
+                                       std::size_t       len,
+                                       std::uint64_t     offset) noexcept
+    : _ctx(ctx)
+    , _opcode(opcode)
+    , _fd(fd)
+    , _addr(addr)
+    , _len(static_cast<std::uint32_t>(len))
+    , _offset(offset) {
+    neo_assert(expects,
+               len <= UINT32_MAX,
+               "io_uring buffers must be smaller than 4GiB. Split larger transfers.",
+               len);
+}
+
+void io_uring_context::operation::await_suspend(std::coroutine_handle<> co) {
+    _co = co;
+    _ctx._enqueue(*this);
+}
+
+std::size_t io_uring_context::operation::await_resume() const {
+    if (_result < 0) {
+        throw_errno(-_result, _opcode == IORING_OP_READ ? "io_uring read" : "io_uring write");
+    }
+    return static_cast<std::size_t>(_result);
+}
+
+void io_uring_context::_enqueue(operation& op) {
+    auto& sqe     = _impl->next_sqe();
+    sqe.opcode    = op._opcode;
+    sqe.fd        = op._fd;
+    sqe.addr      = reinterpret_cast<std::uintptr_t>(op._addr);
+    sqe.len       = op._len;
+    sqe.off       = op._offset;
+    sqe.user_data = reinterpret_cast<std::uintptr_t>(&op);
+    _impl->push_sqe();
+}
+
+io_uring_context::operation
+io_uring_context::read_at(int fd, std::span<std::byte> buf, std::uint64_t offset) noexcept {
+    return operation(*this, IORING_OP_READ, fd, buf.data(), buf.size(), offset);
+}
+
+io_uring_context::operation
+io_uring_context::write_at(int fd, std::span<const std::byte> buf, std::uint64_t offset) noexcept {
+    return operation(*this,
+                     IORING_OP_WRITE,
+                     fd,
+                     const_cast<std::byte*>(buf.data()),
+                     buf.size(),
+                     offset);
+}
+
+std::size_t io_uring_context::in_flight() const noexcept { return _impl->in_flight; }
+
+std::size_t io_uring_context::poll() {
+    _impl->enter(0);
+    return _impl->reap();
+}
+
+std::size_t io_uring_context::run_one() {
+    if (_impl->in_flight == 0) {
+        return 0;
+    }
+    auto n = _impl->reap();
+    if (n == 0) {
+        _impl->enter(1);
+        n = _impl->reap();
+    }
+    return n;
+}
+
+void io_uring_context::_check_stalled() const noexcept {
+    neo_assert(expects,
+               _impl->in_flight != 0,
+               "io_uring_context::run() is waiting on a coroutine that is not waiting for any "
+               "operation of the io_uring_context");
+}
+
+co_resource<file> neo::open_file(std::filesystem::path path, int flags, unsigned mode) {
+    const int fd = ::open(path.c_str(), flags | O_CLOEXEC, static_cast<mode_t>(mode));
+    if (fd < 0) {
+        throw std::system_error(errno,
+                                std::system_category(),
+                                "Failed to open file [" + path.string() + "]");
+    }
+    neo_defer { ::close(fd); };
+    const file f{fd};
+    co_yield f;
+}
+
+#endif  // NEO_OS_IS_LINUX
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "./platform.hpp"
+
+#if (defined(__dds_header_check) || defined(__bpt_header_check)) && !NEO_OS_IS_LINUX
+// Elide this file
+#else
+
+#if !NEO_OS_IS_LINUX
+#error "<neo/io_uring.hpp> is only available on Linux"
+#endif
+
+#include "./await.hpp"
+#include "./await_driver.hpp"
+#include "./co_resource.hpp"
+#include "./fwd.hpp"
+#include "./type_traits.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace neo {
+
+/**
+ * @brief An open file descriptor, as produced by `open_file()`.
+ */
+struct file {
+    int fd = -1;
+};
+
+/**
+ * @brief Open a file for the lifetime of the returned resource.
+ *
+ * The file is opened synchronously using `open()` (with `O_CLOEXEC`), and is closed
+ * when the returned co_resource is destroyed.
+ *
+ * @param path The path to the file to open
+ * @param flags The flags for `open()`, e.g. `O_RDONLY`
+ * @param mode The permissions of the file, if it is created
+ *
+ * @throw std::system_error If the file cannot be opened
+ */
+co_resource<file> open_file(std::filesystem::path path, int flags, unsigned mode = 0644);
+
+/**
+ * @brief A single-threaded completion queue for asynchronous file I/O using Linux io_uring.
+ *
+ * Operations such as `read_at()` and `write_at()` return awaitables. Awaiting one places a
+ * request in the submission queue and suspends the awaiting coroutine. Requests are not
+ * handed to the kernel one at a time: All requests that are queued by the time the context
+ * next polls for completions are submitted with a single system call.
+ *
+ * Coroutines are resumed from within `poll()`, `run_one()`, or `run()`, on the thread that
+ * calls them. The context must only be used from one thread at a time.
+ *
+ * All operations must have completed before the context is destroyed.
+ */
+class io_uring_context {
+    struct impl;
+    std::unique_ptr<impl> _impl;
+
+public:
+    /**
+     * @brief An awaitable for a single io_uring request. Lives in the awaiting
+     * coroutine's frame until the request completes.
+     */
+    class [[nodiscard]] operation {
+        io_uring_context& _ctx;
+        std::uint8_t      _opcode;
+        int               _fd;
+        void*             _addr;
+        std::uint32_t     _len;
+        std::uint64_t     _offset;
+
+        std::coroutine_handle<> _co;
+        std::int32_t            _result = 0;
+
+        friend io_uring_context;
+
+        operation(io_uring_context& ctx,
+                  std::uint8_t      opcode,
+                  int               fd,
+                  void*             addr,
+                  std::size_t       len,
+                  std::uint64_t     offset) noexcept;
+
+    public:
+        constexpr bool await_ready() const noexcept { return false; }
+        void           await_suspend(std::coroutine_handle<> co);
+
+        /**
+         * @brief Obtain the number of bytes transferred.
+         *
+         * @throw std::system_error If the operation failed
+         */
+        std::size_t await_resume() const;
+    };
+
+    /**
+     * @brief Create a new context.
+     *
+     * @param entries The size of the submission queue. If more requests than this are
+     * queued, the queue is submitted early to make room.
+     *
+     * @throw std::system_error If the io_uring cannot be created
+     */
+    explicit io_uring_context(unsigned entries = 256);
+    ~io_uring_context();
+
+    io_uring_context(const io_uring_context&)            = delete;
+    io_uring_context& operator=(const io_uring_context&) = delete;
+
+    /**
+     * @brief Read into the given buffer from the given offset in a file.
+     *
+     * The result of the `co_await` is the number of bytes read, which may be less than
+     * the size of the buffer.
+     */
+    operation read_at(int fd, std::span<std::byte> buf, std::uint64_t offset) noexcept;
+
+    /**
+     * @brief Write the given buffer at the given offset in a file.
+     *
+     * The result of the `co_await` is the number of bytes written, which may be less than
+     * the size of the buffer.
+     */
+    operation write_at(int fd, std::span<const std::byte> buf, std::uint64_t offset) noexcept;
+
+    /// The number of requests that have been queued but have not yet completed
+    std::size_t in_flight() const noexcept;
+
+    /**
+     * @brief Submit all queued requests and resume the coroutines of any completed requests.
+     * Does not block.
+     *
+     * @return The number of coroutines that were resumed
+     */
+    std::size_t poll();
+
+    /**
+     * @brief Submit all queued requests, and block until at least one request has completed,
+     * then resume the coroutines of all completed requests.
+     *
+     * @return The number of coroutines that were resumed. Zero if there were no requests
+     * in flight.
+     */
+    std::size_t run_one();
+
+    /**
+     * @brief Await the given awaitable on the calling thread, running the context until it
+     * completes.
+     *
+     * @pre The awaitable must only wait on operations of this context.
+     */
+    template <awaitable A>
+    await_result_t<A> run(A&& a);
+
+private:
+    void _enqueue(operation& op);
+    void _check_stalled() const noexcept;
+};
+
+template <awaitable A>
+await_result_t<A> io_uring_context::run(A&& a) {
+    auto d = await_driver_detail::make_driver<await_result_t<A>>(NEO_FWD(a));
+    d.start();
+    while (not d.done()) {
+        _check_stalled();
+        run_one();
+    }
+    return d.take();
+}
+
+}  // namespace neo
+
+#endif  // header check guard
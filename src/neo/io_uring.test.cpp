@@ -0,0 +1,185 @@
+#include "./platform.hpp"
+
+#if NEO_OS_IS_LINUX
+
+#include "./io_uring.hpp"
+
+#include "./task.hpp"
+#include "./when_all.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// A scratch file, preferring a tmpfs directory
+struct scratch_file {
+    fs::path path;
+
+    explicit scratch_file(std::string name) {
+        fs::path dir = fs::exists("/dev/shm") ? fs::path("/dev/shm") : fs::temp_directory_path();
+        path = dir / ("neo-io_uring-test-" + std::to_string(::getpid()) + "-" + name);
+    }
+
+    ~scratch_file() {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+};
+
+/**
+ * @brief Create an io_uring_context, or return null if io_uring is unavailable, such as in
+ * containers and under seccomp filters that deny it.
+ */
+std::unique_ptr<neo::io_uring_context> try_make_context(unsigned entries = 256) {
+    std::unique_ptr<neo::io_uring_context> ret;
+    try {
+        ret = std::make_unique<neo::io_uring_context>(entries);
+    } catch (const std::system_error& e) {
+        const auto err = e.code().value();
+        if (e.code().category() != std::system_category() or (err != ENOSYS and err != EPERM)) {
+            throw;
+        }
+        WARN("io_uring is not available, skipping the test: " << e.what());
+    }
+    return ret;
+}
+
+std::span<const std::byte> as_bytes(std::string_view s) {
+    return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+neo::task<std::string>
+read_string(neo::io_uring_context& ctx, int fd, std::size_t size, std::uint64_t offset) {
+    std::string buf(size, '\0');
+    auto        n = co_await ctx.read_at(fd, std::as_writable_bytes(std::span(buf)), offset);
+    buf.resize(n);
+    co_return buf;
+}
+
+}  // namespace
+
+static_assert(neo::awaitable<neo::io_uring_context::operation>);
+
+TEST_CASE("Write and read a file with io_uring") {
+    auto ctx_ = try_make_context();
+    if (not ctx_) {
+        return;
+    }
+    auto& ctx = *ctx_;
+    scratch_file tmp{"rw"};
+    auto         f = neo::open_file(tmp.path, O_RDWR | O_CREAT | O_TRUNC);
+
+    auto n_written = ctx.run(ctx.write_at(f->fd, as_bytes("Hello, io_uring!"), 0));
+    CHECK(n_written == 16);
+    CHECK(ctx.in_flight() == 0);
+
+    CHECK(ctx.run(read_string(ctx, f->fd, 5, 7)) == "io_ur");
+    // Short read at the end of the file
+    CHECK(ctx.run(read_string(ctx, f->fd, 100, 10)) == "uring!");
+}
+
+TEST_CASE("Batch many concurrent reads") {
+    scratch_file tmp{"batch"};
+    // Fill a file with a known pattern of 4-byte blocks
+    std::string content;
+    for (int i = 0; i < 4096; ++i) {
+        char block[5];
+        std::snprintf(block, sizeof block, "%04d", i % 10000);
+        content.append(block, 4);
+    }
+    // A small ring, so that the concurrent requests overflow the submission queue
+    auto ctx_ = try_make_context(4);
+    if (not ctx_) {
+        return;
+    }
+    auto& ctx = *ctx_;
+    auto  f   = neo::open_file(tmp.path, O_RDWR | O_CREAT | O_TRUNC);
+    REQUIRE(ctx.run(ctx.write_at(f->fd, as_bytes(content), 0)) == content.size());
+
+    auto read_block = [&](int i) { return read_string(ctx, f->fd, 4, i * 4u); };
+    auto both       = ctx.run(neo::when_all(neo::when_all(read_block(0),
+                                                    read_block(1),
+                                                    read_block(2),
+                                                    read_block(3),
+                                                    read_block(4)),
+                                      neo::when_all(read_block(1000),
+                                                    read_block(1001),
+                                                    read_block(2000),
+                                                    read_block(3000),
+                                                    read_block(4095))));
+    auto& [a, b, c, d, e] = std::get<0>(both);
+    CHECK(a == "0000");
+    CHECK(b == "0001");
+    CHECK(c == "0002");
+    CHECK(d == "0003");
+    CHECK(e == "0004");
+    auto& [v, w, x, y, z] = std::get<1>(both);
+    CHECK(v == "1000");
+    CHECK(w == "1001");
+    CHECK(x == "2000");
+    CHECK(y == "3000");
+    CHECK(z == "4095");
+}
+
+TEST_CASE("Stream a large file through a coroutine") {
+    auto ctx_ = try_make_context();
+    if (not ctx_) {
+        return;
+    }
+    auto& ctx = *ctx_;
+    scratch_file tmp{"stream"};
+    auto         f = neo::open_file(tmp.path, O_RDWR | O_CREAT | O_TRUNC);
+
+    std::vector<std::byte> data(1024 * 1024 * 4);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::byte>(i * 31);
+    }
+    REQUIRE(ctx.run(ctx.write_at(f->fd, data, 0)) == data.size());
+
+    auto checksum = ctx.run([&]() -> neo::task<std::uint64_t> {
+        std::vector<std::byte> buf(64 * 1024);
+        std::uint64_t          offset = 0;
+        std::uint64_t          sum    = 0;
+        while (auto n = co_await ctx.read_at(f->fd, buf, offset)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += static_cast<std::uint64_t>(buf[i]);
+            }
+            offset += n;
+        }
+        co_return sum;
+    }());
+    std::uint64_t expect = 0;
+    for (auto b : data) {
+        expect += static_cast<std::uint64_t>(b);
+    }
+    CHECK(checksum == expect);
+}
+
+TEST_CASE("io_uring errors") {
+    auto ctx_ = try_make_context();
+    if (not ctx_) {
+        return;
+    }
+    auto& ctx = *ctx_;
+    std::byte buf[16];
+    // Reading from a bad file descriptor
+    CHECK_THROWS_AS(ctx.run(ctx.read_at(-1, buf, 0)), std::system_error);
+    CHECK(ctx.in_flight() == 0);
+    // Opening a file that does not exist
+    CHECK_THROWS_AS(neo::open_file("/nonexistent/file.txt", O_RDONLY), std::system_error);
+}
+
+#endif  // NEO_OS_IS_LINUX
@@ -0,0 +1,390 @@
+#pragma once
+
+#include "./assert.hpp"
+#include "./concepts.hpp"
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./storage.hpp"
+
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace neo {
+
+namespace mpmc_detail {
+
+/// Base of all awaiters that may be enqueued on a waiter list
+struct waiter_node {
+    waiter_node*            next = nullptr;
+    std::coroutine_handle<> co{};
+};
+
+/// An intrusive FIFO of suspended awaiters. Guarded by the channel's mutex.
+struct waiter_list {
+    waiter_node* head = nullptr;
+    waiter_node* tail = nullptr;
+
+    bool empty() const noexcept { return head == nullptr; }
+
+    void push(waiter_node& n) noexcept {
+        n.next = nullptr;
+        if (tail) {
+            tail->next = &n;
+        } else {
+            head = &n;
+        }
+        tail = &n;
+    }
+
+    waiter_node& pop() noexcept {
+        auto& n = *head;
+        head    = n.next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        return n;
+    }
+};
+
+}  // namespace mpmc_detail
+
+/**
+ * @brief A bounded multi-producer/multi-consumer channel with awaitable send and receive.
+ *
+ * Values are exchanged through a lock-free ring buffer (D. Vyukov's bounded MPMC queue).
+ * Sending and receiving never take a lock unless the buffer is full or empty, respectively.
+ * In that case the awaiting coroutine is suspended and queued, and is resumed by whichever
+ * thread next makes room (for senders) or produces a value (for receivers). Suspended
+ * coroutines are handed their value/slot directly before they are resumed, so a resumed
+ * awaiter never needs to retry.
+ *
+ * @tparam T The type of values sent through the channel. Must be move-constructible.
+ *
+ * @note Coroutines are resumed inline on the thread that completes their operation. Use
+ * a scheduler to move them elsewhere if required.
+ *
+ * The channel is neither copyable nor movable, and must outlive all awaiters.
+ */
+template <typename T>
+class mpmc_channel {
+    struct cell {
+        std::atomic<std::size_t> seq;
+        storage_for<T>           value;
+    };
+
+    // Each index is on its own cache line, so producers and consumers do not contend
+    alignas(64) std::atomic<std::size_t> _enqueue_pos{0};
+    alignas(64) std::atomic<std::size_t> _dequeue_pos{0};
+    alignas(64) std::size_t _mask;
+    std::unique_ptr<cell[]> _cells;
+    std::atomic<bool>       _closed{false};
+
+    // Slow path: waiting coroutines
+    std::mutex                 _mtx;
+    mpmc_detail::waiter_list   _send_waiters;
+    mpmc_detail::waiter_list   _recv_waiters;
+    std::atomic<std::ptrdiff_t> _n_send_waiting{0};
+    std::atomic<std::ptrdiff_t> _n_recv_waiting{0};
+
+    // Set in `_enqueue_pos` by `close()`, so that no push can reserve a cell afterwards
+    static constexpr std::size_t closed_bit = ~(~std::size_t(0) >> 1);
+
+    bool _try_push_raw(T& value) noexcept(nothrow_constructible_from<T, T>) {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & closed_bit) {
+                return false;
+            }
+            auto& c    = _cells[pos & _mask];
+            auto  seq  = c.seq.load(std::memory_order_acquire);
+            auto  diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value.construct(NEO_MOVE(value));
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Full
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    optional<T> _try_pop_raw() noexcept(nothrow_constructible_from<T, T>) {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c    = _cells[pos & _mask];
+            auto  seq  = c.seq.load(std::memory_order_acquire);
+            auto  diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    optional<T> ret{NEO_MOVE(c.value).get()};
+                    c.value.destroy();
+                    c.seq.store(pos + _mask + 1, std::memory_order_release);
+                    return ret;
+                }
+            } else if (diff < 0) {
+                // Empty
+                return std::nullopt;
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Give a waiting receiver a value, if there is both a waiter and a value
+    void _wake_receiver() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_n_recv_waiting.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        std::unique_lock lk{_mtx};
+        if (_recv_waiters.empty()) {
+            return;
+        }
+        auto v = _try_pop_raw();
+        if (not v.has_value()) {
+            return;
+        }
+        auto& w = static_cast<receive_awaiter&>(_recv_waiters.pop());
+        _n_recv_waiting.fetch_sub(1, std::memory_order_relaxed);
+        w._slot = NEO_MOVE(v);
+        lk.unlock();
+        // We popped a value, so there may be room for a sender as well
+        _wake_sender();
+        w.co.resume();
+    }
+
+    // Push the value of a waiting sender, if there is both a waiter and room for the value
+    void _wake_sender() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_n_send_waiting.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        std::unique_lock lk{_mtx};
+        if (_send_waiters.empty()) {
+            return;
+        }
+        auto& w = static_cast<send_awaiter&>(*_send_waiters.head);
+        if (not _try_push_raw(w._value)) {
+            return;
+        }
+        _send_waiters.pop();
+        _n_send_waiting.fetch_sub(1, std::memory_order_relaxed);
+        w._sent = true;
+        lk.unlock();
+        _wake_receiver();
+        w.co.resume();
+    }
+
+public:
+    /**
+     * @brief Create a new channel that can buffer at least `capacity` values.
+     *
+     * The capacity is rounded up to a power of two.
+     */
+    explicit mpmc_channel(std::size_t capacity) {
+        neo_assert(expects, capacity > 0, "mpmc_channel capacity must be non-zero");
+        capacity = std::bit_ceil(capacity < 2 ? std::size_t(2) : capacity);
+        _mask    = capacity - 1;
+        _cells   = std::make_unique<cell[]>(capacity);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_channel(const mpmc_channel&)            = delete;
+    mpmc_channel& operator=(const mpmc_channel&) = delete;
+
+    ~mpmc_channel() {
+        while (_try_pop_raw().has_value()) {
+        }
+    }
+
+    /// The maximum number of values that can be buffered without suspending a sender
+    std::size_t capacity() const noexcept { return _mask + 1; }
+
+    /// Determine whether `close()` has been called
+    bool is_closed() const noexcept { return _closed.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Attempt to push a value without suspending.
+     *
+     * @return true If the value was moved into the channel.
+     * @return false If the channel is full or closed. The value is left unmodified.
+     */
+    bool try_send(T& value) {
+        if (not _try_push_raw(value)) {
+            return false;
+        }
+        _wake_receiver();
+        return true;
+    }
+    bool try_send(T&& value) { return try_send(value); }
+
+    /**
+     * @brief Attempt to receive a value without suspending.
+     *
+     * @return optional<T> The received value, or `nullopt` if the channel is empty.
+     */
+    optional<T> try_receive() {
+        auto v = _try_pop_raw();
+        if (v.has_value()) {
+            _wake_sender();
+        }
+        return v;
+    }
+
+    /**
+     * @brief Close the channel.
+     *
+     * Subsequent and suspended sends will fail. Receivers will continue to receive buffered
+     * values, after which they will receive `nullopt`. Sends that are already pushing a value
+     * on other threads finish first, so every successful send can be received.
+     */
+    void close() {
+        // Stop new pushes, and wait for the pushes that have already reserved a cell to publish
+        // their values. Receivers that see the channel closed must also see those values.
+        const auto end = _enqueue_pos.fetch_or(closed_bit, std::memory_order_relaxed)
+            & ~closed_bit;
+        for (auto pos = _dequeue_pos.load(std::memory_order_relaxed); pos < end; ++pos) {
+            while (_cells[pos & _mask].seq.load(std::memory_order_acquire) == pos) {
+                std::this_thread::yield();
+            }
+        }
+        mpmc_detail::waiter_list senders;
+        mpmc_detail::waiter_list receivers;
+        {
+            std::scoped_lock lk{_mtx};
+            _closed.store(true, std::memory_order_release);
+            std::swap(senders, _send_waiters);
+            std::swap(receivers, _recv_waiters);
+            _n_send_waiting.store(0, std::memory_order_relaxed);
+            _n_recv_waiting.store(0, std::memory_order_relaxed);
+        }
+        while (not senders.empty()) {
+            senders.pop().co.resume();
+        }
+        while (not receivers.empty()) {
+            auto& w = static_cast<receive_awaiter&>(receivers.pop());
+            // Buffered values might have been left behind when the last sender raced with us
+            w._slot = _try_pop_raw();
+            w.co.resume();
+        }
+    }
+
+    /**
+     * @brief Awaiter returned by `send()`. The result of `co_await` is a `bool` that is
+     * `false` if the channel was closed before the value could be sent.
+     */
+    class [[nodiscard]] send_awaiter : mpmc_detail::waiter_node {
+        friend mpmc_channel;
+
+        mpmc_channel& _chan;
+        T             _value;
+        bool          _sent = false;
+
+    public:
+        send_awaiter(mpmc_channel& ch, T&& v)
+            : _chan(ch)
+            , _value(NEO_MOVE(v)) {}
+
+        bool await_ready() {
+            _sent = _chan.try_send(_value);
+            return _sent or _chan.is_closed();
+        }
+
+        bool await_suspend(std::coroutine_handle<> co) {
+            this->co = co;
+            std::unique_lock lk{_chan._mtx};
+            _chan._n_send_waiting.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (not _chan.is_closed() and not _chan._try_push_raw(_value)) {
+                _chan._send_waiters.push(*this);
+                return true;
+            }
+            _chan._n_send_waiting.fetch_sub(1, std::memory_order_relaxed);
+            _sent = not _chan.is_closed();
+            lk.unlock();
+            if (_sent) {
+                _chan._wake_receiver();
+            }
+            return false;
+        }
+
+        bool await_resume() const noexcept { return _sent; }
+    };
+
+    /**
+     * @brief Awaiter returned by `receive()`. The result of `co_await` is an `optional<T>`
+     * that is `nullopt` if the channel was closed and empty.
+     */
+    class [[nodiscard]] receive_awaiter : mpmc_detail::waiter_node {
+        friend mpmc_channel;
+
+        mpmc_channel& _chan;
+        optional<T>   _slot;
+
+    public:
+        explicit receive_awaiter(mpmc_channel& ch) noexcept
+            : _chan(ch) {}
+
+        bool await_ready() {
+            _slot = _chan.try_receive();
+            if (_slot.has_value() or not _chan.is_closed()) {
+                return _slot.has_value();
+            }
+            // Values that were sent before the close may have been published since we looked
+            _slot = _chan.try_receive();
+            return true;
+        }
+
+        bool await_suspend(std::coroutine_handle<> co) {
+            this->co = co;
+            std::unique_lock lk{_chan._mtx};
+            _chan._n_recv_waiting.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _slot = _chan._try_pop_raw();
+            if (not _slot.has_value() and not _chan.is_closed()) {
+                _chan._recv_waiters.push(*this);
+                return true;
+            }
+            _chan._n_recv_waiting.fetch_sub(1, std::memory_order_relaxed);
+            lk.unlock();
+            if (_slot.has_value()) {
+                _chan._wake_sender();
+            }
+            return false;
+        }
+
+        optional<T> await_resume() noexcept(nothrow_constructible_from<T, T>) {
+            return NEO_MOVE(_slot);
+        }
+    };
+
+    /**
+     * @brief Send a value into the channel, suspending while the channel is full.
+     *
+     * @return An awaitable yielding `true` if the value was sent, or `false` if the channel
+     * was closed.
+     */
+    send_awaiter send(T value) { return send_awaiter{*this, NEO_MOVE(value)}; }
+
+    /**
+     * @brief Receive a value from the channel, suspending while the channel is empty.
+     *
+     * @return An awaitable yielding the next value, or `nullopt` if the channel is closed and
+     * all buffered values have been received.
+     */
+    receive_awaiter receive() noexcept { return receive_awaiter{*this}; }
+};
+
+}  // namespace neo
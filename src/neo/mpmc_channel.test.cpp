@@ -0,0 +1,163 @@
+#include "./mpmc_channel.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// A fire-and-forget coroutine that starts immediately
+struct detached {
+    struct promise_type {
+        detached            get_return_object() noexcept { return {}; }
+        std::suspend_never  initial_suspend() noexcept { return {}; }
+        std::suspend_never  final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() { std::terminate(); }
+    };
+};
+
+// (Catch assertions are not thread-safe, so we only count events here)
+detached send_all(neo::mpmc_channel<int>& ch, int first, int count, std::atomic<int>& n_done) {
+    for (int i = first; i < first + count; ++i) {
+        if (not co_await ch.send(i)) {
+            co_return;
+        }
+    }
+    ++n_done;
+}
+
+detached receive_all(neo::mpmc_channel<int>& ch,
+                     std::atomic<long long>& sum,
+                     std::atomic<int>&       n_received,
+                     std::atomic<int>&       n_finished) {
+    while (auto v = co_await ch.receive()) {
+        sum += *v;
+        ++n_received;
+    }
+    ++n_finished;
+}
+
+}  // namespace
+
+TEST_CASE("Send and receive without suspending") {
+    neo::mpmc_channel<std::string> ch{3};
+    CHECK(ch.capacity() == 4);
+    CHECK(ch.try_send("Hello"));
+    CHECK(ch.try_send("world"));
+    auto s = ch.try_receive();
+    REQUIRE(s.has_value());
+    CHECK(*s == "Hello");
+    s = ch.try_receive();
+    CHECK(*s == "world");
+    CHECK_FALSE(ch.try_receive().has_value());
+}
+
+TEST_CASE("Suspend while empty and full") {
+    neo::mpmc_channel<int> ch{2};
+    std::atomic<long long> sum        = 0;
+    std::atomic<int>       n_received = 0;
+    std::atomic<int>       n_finished = 0;
+    std::atomic<int>       n_sent     = 0;
+    // The receiver suspends immediately
+    receive_all(ch, sum, n_received, n_finished);
+    CHECK(n_received == 0);
+    // The sender resumes the receiver inline
+    send_all(ch, 1, 10, n_sent);
+    CHECK(n_sent == 1);
+    CHECK(n_received == 10);
+    CHECK(sum == 55);
+    // Closing the channel ends the receive loop
+    ch.close();
+    CHECK(n_finished == 1);
+    CHECK_FALSE(ch.try_send(4));
+}
+
+TEST_CASE("Suspended senders fail when closed") {
+    neo::mpmc_channel<int> ch{2};
+    bool                   result = true;
+    [](neo::mpmc_channel<int>& ch, bool& result) -> detached {
+        co_await ch.send(1);
+        co_await ch.send(2);
+        result = co_await ch.send(3);
+    }(ch, result);
+    CHECK(result);
+    ch.close();
+    CHECK_FALSE(result);
+    // Buffered values may still be received
+    CHECK(ch.try_receive() == 1);
+    CHECK(ch.try_receive() == 2);
+    CHECK_FALSE(ch.try_receive().has_value());
+}
+
+TEST_CASE("Many producers and consumers on many threads") {
+    neo::mpmc_channel<int> ch{8};
+    constexpr int          n_producers       = 4;
+    constexpr int          coros_per_thread  = 8;
+    constexpr int          values_per_coro   = 500;
+    constexpr int          n_consumers       = 6;
+    std::atomic<long long> sum               = 0;
+    std::atomic<int>       n_received        = 0;
+    std::atomic<int>       n_finished        = 0;
+    std::atomic<int>       n_producers_done  = 0;
+
+    for (int i = 0; i < n_consumers; ++i) {
+        receive_all(ch, sum, n_received, n_finished);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_producers; ++t) {
+        threads.emplace_back([&, t] {
+            for (int c = 0; c < coros_per_thread; ++c) {
+                send_all(ch,
+                         (t * coros_per_thread + c) * values_per_coro,
+                         values_per_coro,
+                         n_producers_done);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // Suspended senders are resumed by consumers, which are resumed by senders, so all
+    // values will have been transferred once all producer coroutines have finished
+    while (n_producers_done != n_producers * coros_per_thread) {
+        std::this_thread::yield();
+    }
+    ch.close();
+    constexpr long long total = n_producers * coros_per_thread * values_per_coro;
+    CHECK(n_received == total);
+    CHECK(sum == total * (total - 1) / 2);
+    CHECK(n_finished == n_consumers);
+}
+
+TEST_CASE("Close while sending") {
+    // Every value that is sent successfully must be received, even if the channel is closed
+    // while the value is being pushed
+    int n_lost = 0;
+    for (int round = 0; round < 200; ++round) {
+        neo::mpmc_channel<int> ch{4};
+        std::atomic<long long> sum        = 0;
+        std::atomic<int>       n_received = 0;
+        std::atomic<int>       n_finished = 0;
+        receive_all(ch, sum, n_received, n_finished);
+        int         n_sent = 0;
+        std::thread sender{[&] {
+            while (not ch.is_closed()) {
+                n_sent += ch.try_send(1) ? 1 : 0;
+            }
+        }};
+        std::this_thread::sleep_for(std::chrono::microseconds(round % 20 * 10));
+        ch.close();
+        sender.join();
+        // The receiver has finished, so it must have taken every value
+        CHECK(n_finished == 1);
+        CHECK_FALSE(ch.try_receive().has_value());
+        n_lost += n_sent - n_received;
+    }
+    CHECK(n_lost == 0);
+}
@@ -0,0 +1,95 @@
+#include "./pipeline.hpp"
+
+#include "./assert.hpp"
+#include "./thread_pool_scheduler.hpp"
+
+#include <algorithm>
+#include <coroutine>
+#include <latch>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace neo;
+using pipeline_detail::stage_base;
+
+namespace {
+
+/// A coroutine that runs to completion without being awaited
+struct detached_job {
+    struct promise_type {
+        detached_job       get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void               return_void() const noexcept {}
+        // Only scheduling onto the pool may throw, which happens before the first suspension
+        void unhandled_exception() const { throw; }
+    };
+};
+
+detached_job run_on_pool(thread_pool_scheduler& pool, stage_base& s, std::latch& done) {
+    co_await pool.schedule();
+    s.run();
+    done.count_down();
+}
+
+}  // namespace
+
+void pipeline_detail::state::fail() noexcept {
+    std::scoped_lock lk{exc_mtx};
+    if (not exc) {
+        exc = std::current_exception();
+    }
+}
+
+void pipeline::run() {
+    neo_assert(expects, not _st->started, "A neo::pipeline can only be run once");
+    _st->started = true;
+
+    auto& stages = _st->stages;
+    // A pooled stage holds its worker until it finishes, so a pool without a worker for each
+    // of its stages would deadlock
+    for (auto& s : stages) {
+        if (not s->pool) {
+            continue;
+        }
+        const auto n_stages = std::ranges::count(stages, s->pool, [](auto& p) { return p->pool; });
+        if (static_cast<std::size_t>(n_stages) > s->pool->size()) {
+            throw std::invalid_argument("neo::pipeline places " + std::to_string(n_stages)
+                                        + " stages on a thread_pool_scheduler with only "
+                                        + std::to_string(s->pool->size()) + " workers");
+        }
+    }
+
+    std::latch               done{static_cast<std::ptrdiff_t>(stages.size())};
+    std::vector<std::thread> threads;
+    threads.reserve(stages.size());
+    for (auto it = stages.begin(); it != stages.end(); ++it) {
+        auto& s = **it;
+        try {
+            if (s.pool) {
+                run_on_pool(*s.pool, s, done);
+            } else {
+                threads.emplace_back([&s, &done] {
+                    s.run();
+                    done.count_down();
+                });
+            }
+        } catch (...) {
+            // The remaining stages will never run. Unblock the stages that are running.
+            _st->fail();
+            for (; it != stages.end(); ++it) {
+                (*it)->finish();
+                done.count_down();
+            }
+            break;
+        }
+    }
+    done.wait();
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (_st->exc) {
+        std::rethrow_exception(_st->exc);
+    }
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+#include "./concepts.hpp"
+#include "./fwd.hpp"
+#include "./invoke.hpp"
+#include "./optional.hpp"
+#include "./range_concepts.hpp"
+#include "./spsc_queue.hpp"
+#include "./type_traits.hpp"
+#include "./unit.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace neo {
+
+class thread_pool_scheduler;
+class pipeline;
+
+template <typename T>
+class pipeline_builder;
+
+/// Options that apply to every stage of a pipeline
+struct pipeline_options {
+    /// The number of values that may be buffered between two stages
+    std::size_t queue_capacity = 1024;
+    /// The number of values that a stage hands to the next stage at once
+    std::size_t batch_size = 32;
+};
+
+namespace pipeline_detail {
+
+/// A type-erased stage, bound to its input and output queues
+struct stage_base {
+    thread_pool_scheduler* pool = nullptr;
+
+    virtual ~stage_base() = default;
+    /// Run the stage to completion, then finish it
+    virtual void run() noexcept = 0;
+    /// Stop the stage upstream of this one, and let the stage downstream of it drain
+    virtual void finish() noexcept = 0;
+};
+
+/// The stages and queues of a pipeline under construction
+struct state {
+    pipeline_options                         opts;
+    std::vector<std::unique_ptr<stage_base>> stages;
+    // The queues between the stages. Owned here so that they outlive every stage.
+    std::vector<std::shared_ptr<void>> queues;
+
+    std::mutex         exc_mtx;
+    std::exception_ptr exc;
+    bool               started = false;
+
+    /// Record the in-flight exception, if it is the first one
+    void fail() noexcept;
+
+    template <typename T>
+    spsc_queue<T>* new_queue() {
+        auto q = std::make_shared<spsc_queue<T>>(opts.queue_capacity, opts.batch_size);
+        queues.push_back(q);
+        return q.get();
+    }
+};
+
+template <typename In, typename Out, typename Body>
+class stage final : public stage_base {
+    state&           _st;
+    spsc_queue<In>*  _in;
+    spsc_queue<Out>* _out;
+    Body             _body;
+
+public:
+    stage(state& st, spsc_queue<In>* in, spsc_queue<Out>* out, Body&& b)
+        : _st(st)
+        , _in(in)
+        , _out(out)
+        , _body(NEO_MOVE(b)) {}
+
+    void run() noexcept override {
+        try {
+            _body(_in, _out);
+        } catch (...) {
+            _st.fail();
+        }
+        finish();
+    }
+
+    void finish() noexcept override {
+        if (_in) {
+            _in->cancel();
+        }
+        if (_out) {
+            _out->close();
+        }
+    }
+};
+
+// Hand each value of the range to the output queue, until the consumer cancels
+template <typename Range, typename Out>
+void push_all(Range&& r, spsc_queue<Out>& out) {
+    for (auto&& v : r) {
+        if (not out.emplace(NEO_FWD(v))) {
+            break;
+        }
+    }
+}
+
+}  // namespace pipeline_detail
+
+/**
+ * @brief The input of a pipeline stage: An input range of the values produced by the
+ * previous stage.
+ *
+ * A stage that is given a `pipeline_input<T>&` may consume it at its own pace, e.g. with a
+ * generator that reads several values for each value it yields, or vice versa.
+ */
+template <typename T>
+class pipeline_input {
+    spsc_queue<T>& _queue;
+    // Called before waiting on an empty queue, to hand our own staged output downstream
+    void (*_flush)(void*) noexcept = nullptr;
+    void*       _flush_ctx         = nullptr;
+    optional<T> _cur;
+
+public:
+    template <typename Out>
+    pipeline_input(spsc_queue<T>& q, spsc_queue<Out>* out) noexcept
+        : _queue(q) {
+        if (out) {
+            _flush     = [](void* q) noexcept { static_cast<spsc_queue<Out>*>(q)->flush(); };
+            _flush_ctx = out;
+        }
+    }
+
+    pipeline_input(const pipeline_input&) = delete;
+
+    /**
+     * @brief Take the next value, blocking until the previous stage produces it.
+     *
+     * @return The value, or `nullopt` if the previous stage has finished.
+     */
+    optional<T> next() {
+        auto v = _queue.try_pop();
+        if (not v.has_value()) {
+            if (_flush) {
+                _flush(_flush_ctx);
+            }
+            v = _queue.pop();
+        }
+        return v;
+    }
+
+    class iterator {
+        pipeline_input* _self = nullptr;
+
+        friend pipeline_input;
+        explicit iterator(pipeline_input& s) noexcept
+            : _self(&s) {}
+
+    public:
+        using value_type      = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+
+        T& operator*() const noexcept { return *_self->_cur; }
+
+        iterator& operator++() {
+            _self->_cur = _self->next();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return not _self->_cur.has_value();
+        }
+    };
+
+    /// Take the first value, and return an iterator to it
+    iterator begin() {
+        _cur = next();
+        return iterator{*this};
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+/**
+ * @brief A pipeline that is being built. Each call to `then()` appends a stage.
+ *
+ * @tparam T The type of values produced by the last stage so far.
+ */
+template <typename T>
+class pipeline_builder {
+    std::unique_ptr<pipeline_detail::state> _st;
+    spsc_queue<T>*                          _out;
+
+    template <typename>
+    friend class pipeline_builder;
+    friend pipeline;
+
+    pipeline_builder(std::unique_ptr<pipeline_detail::state> st, spsc_queue<T>* out) noexcept
+        : _st(NEO_MOVE(st))
+        , _out(out) {}
+
+    template <typename Out, typename Body>
+    void _add(Body&& body, spsc_queue<Out>* out, thread_pool_scheduler* pool) {
+        auto s = std::make_unique<pipeline_detail::stage<T, Out, remove_cvref_t<Body>>>(
+            *_st, _out, out, NEO_FWD(body));
+        s->pool = pool;
+        _st->stages.push_back(NEO_MOVE(s));
+    }
+
+    template <typename F>
+    auto _then(F&& fn, thread_pool_scheduler* pool) {
+        if constexpr (invocable2<F&, pipeline_input<T>&>) {
+            // A stage that consumes its input as a range, and returns a range
+            using range_type = invoke_result_t<F&, pipeline_input<T>&>;
+            static_assert(ranges::range<range_type>,
+                          "A pipeline stage that accepts a pipeline_input<T>& must return a "
+                          "range of its output values (e.g. a neo::generator)");
+            using out_type = remove_cvref_t<ranges::range_reference_t<range_type>>;
+            auto out       = _st->new_queue<out_type>();
+            _add(
+                [fn = NEO_FWD(fn)](spsc_queue<T>* in, spsc_queue<out_type>* out) mutable {
+                    pipeline_input<T> input{*in, out};
+                    pipeline_detail::push_all(NEO_INVOKE(fn, input), *out);
+                },
+                out,
+                pool);
+            return pipeline_builder<out_type>{NEO_MOVE(_st), out};
+        } else {
+            // A stage that maps each input value to an output value
+            static_assert(invocable2<F&, T&&>,
+                          "A pipeline stage must accept either a pipeline_input<T>& or a T&&");
+            using out_type = remove_cvref_t<invoke_result_t<F&, T&&>>;
+            static_assert(not void_type<out_type>,
+                          "A pipeline stage that returns void must be added with sink()");
+            auto out = _st->new_queue<out_type>();
+            _add(
+                [fn = NEO_FWD(fn)](spsc_queue<T>* in, spsc_queue<out_type>* out) mutable {
+                    pipeline_input<T> input{*in, out};
+                    while (auto v = input.next()) {
+                        if (not out->emplace(NEO_INVOKE(fn, NEO_MOVE(*v)))) {
+                            break;
+                        }
+                    }
+                },
+                out,
+                pool);
+            return pipeline_builder<out_type>{NEO_MOVE(_st), out};
+        }
+    }
+
+    template <typename F>
+    pipeline _sink(F&& fn, thread_pool_scheduler* pool);
+
+public:
+    /**
+     * @brief Append a stage that transforms the values of the previous stage.
+     *
+     * The stage is either:
+     *
+     * - A function that accepts a `T&&` and returns a value for the next stage, or
+     * - A function that accepts a `pipeline_input<T>&` and returns a range (such as a
+     *   `neo::generator` or a `neo::channel`) of the values for the next stage.
+     *
+     * The stage runs on its own thread, or on a worker of `pool` if one is given.
+     */
+    template <typename F>
+    [[nodiscard]] auto then(F&& fn) && {
+        return _then(NEO_FWD(fn), nullptr);
+    }
+
+    template <typename F>
+    [[nodiscard]] auto then(F&& fn, thread_pool_scheduler& pool) && {
+        return _then(NEO_FWD(fn), &pool);
+    }
+
+    /**
+     * @brief Append the final stage, which consumes the values of the previous stage, and
+     * return the completed pipeline.
+     *
+     * The sink is either a function that accepts each `T&&`, or a function that accepts
+     * the whole `pipeline_input<T>&`. The sink runs on its own thread, or on a worker of
+     * `pool` if one is given.
+     */
+    template <typename F>
+    [[nodiscard]] pipeline sink(F&& fn) &&;
+
+    template <typename F>
+    [[nodiscard]] pipeline sink(F&& fn, thread_pool_scheduler& pool) &&;
+};
+
+/**
+ * @brief A chain of stages that run in parallel, each on its own thread, and pass values
+ * along through bounded queues.
+ *
+ * ```
+ * auto p = neo::pipeline::from([&] { return decode(file); })
+ *              .then([](chunk c) { return parse(c); })
+ *              .then(transform_records, pool)
+ *              .sink([&](record r) { db.insert(r); });
+ * p.run();
+ * ```
+ *
+ * Each stage is an ordinary function or coroutine, and does not need to know that it runs
+ * in a pipeline. Stages are connected by `spsc_queue`s: When a stage gets ahead of the next
+ * stage and fills its queue, it blocks until the next stage catches up. To keep the threads
+ * from contending on every value, values are handed over in batches of
+ * `pipeline_options::batch_size`, or whenever a stage runs out of input.
+ *
+ * If a stage throws, the stages upstream of it are stopped, the stages downstream of it
+ * finish with the values that were already produced, and `run()` rethrows the exception.
+ *
+ * A stage placed on a `thread_pool_scheduler` occupies one of its workers until the stage
+ * finishes, since waiting on a queue blocks the thread. The pool must have a worker for each
+ * stage that is placed on it.
+ */
+class pipeline {
+    std::unique_ptr<pipeline_detail::state> _st;
+
+    template <typename>
+    friend class pipeline_builder;
+
+    explicit pipeline(std::unique_ptr<pipeline_detail::state> st) noexcept
+        : _st(NEO_MOVE(st)) {}
+
+    template <typename S>
+    static auto _from(S&& src, thread_pool_scheduler* pool, pipeline_options opts) {
+        auto st  = std::make_unique<pipeline_detail::state>();
+        st->opts = opts;
+        auto invoke_source = [src = NEO_FWD(src)]() mutable -> decltype(auto) {
+            if constexpr (invocable2<decltype(src)&>) {
+                return NEO_INVOKE(src);
+            } else {
+                return NEO_MOVE(src);
+            }
+        };
+        using range_type = remove_cvref_t<decltype(invoke_source())>;
+        static_assert(ranges::range<range_type>,
+                      "The source of a pipeline must be a range, or a function that returns a "
+                      "range");
+        using out_type = remove_cvref_t<ranges::range_reference_t<range_type>>;
+        auto out       = st->new_queue<out_type>();
+        auto body      = [invoke_source = NEO_MOVE(invoke_source)](
+                        spsc_queue<unit>*, spsc_queue<out_type>* out) mutable {
+            pipeline_detail::push_all(invoke_source(), *out);
+        };
+        auto s = std::make_unique<pipeline_detail::stage<unit, out_type, decltype(body)>>(
+            *st, nullptr, out, NEO_MOVE(body));
+        s->pool = pool;
+        st->stages.push_back(NEO_MOVE(s));
+        return pipeline_builder<out_type>{NEO_MOVE(st), out};
+    }
+
+public:
+    /**
+     * @brief Begin a pipeline with the given source stage.
+     *
+     * @param src A range, or a function that returns a range, of the values for the first
+     * stage. A function is called on the thread of the source stage.
+     * @param pool If given, the source stage runs on a worker of this pool.
+     */
+    template <typename S>
+    [[nodiscard]] static auto from(S&& src, pipeline_options opts = {}) {
+        return _from(NEO_FWD(src), nullptr, opts);
+    }
+
+    template <typename S>
+    [[nodiscard]] static auto
+    from(S&& src, thread_pool_scheduler& pool, pipeline_options opts = {}) {
+        return _from(NEO_FWD(src), &pool, opts);
+    }
+
+    pipeline(pipeline&&) noexcept            = default;
+    pipeline& operator=(pipeline&&) noexcept = default;
+
+    /// The number of stages in the pipeline, including the source and the sink
+    std::size_t size() const noexcept { return _st->stages.size(); }
+
+    /**
+     * @brief Run every stage of the pipeline, and block until all of them have finished.
+     *
+     * If any stage throws, rethrows the first exception. A pipeline can only be run once.
+     *
+     * @throw std::invalid_argument If more stages are placed on a `thread_pool_scheduler`
+     * than it has workers. No stage is run.
+     */
+    void run();
+};
+
+template <typename T>
+template <typename F>
+pipeline pipeline_builder<T>::_sink(F&& fn, thread_pool_scheduler* pool) {
+    if constexpr (invocable2<F&, pipeline_input<T>&>) {
+        _add<unit>(
+            [fn = NEO_FWD(fn)](spsc_queue<T>* in, spsc_queue<unit>*) mutable {
+                pipeline_input<T> input{*in, static_cast<spsc_queue<unit>*>(nullptr)};
+                NEO_INVOKE(fn, input);
+            },
+            nullptr,
+            pool);
+    } else {
+        static_assert(invocable2<F&, T&&>,
+                      "A pipeline sink must accept either a pipeline_input<T>& or a T&&");
+        _add<unit>(
+            [fn = NEO_FWD(fn)](spsc_queue<T>* in, spsc_queue<unit>*) mutable {
+                pipeline_input<T> input{*in, static_cast<spsc_queue<unit>*>(nullptr)};
+                while (auto v = input.next()) {
+                    NEO_INVOKE(fn, NEO_MOVE(*v));
+                }
+            },
+            nullptr,
+            pool);
+    }
+    return pipeline{NEO_MOVE(_st)};
+}
+
+template <typename T>
+template <typename F>
+pipeline pipeline_builder<T>::sink(F&& fn) && {
+    return _sink(NEO_FWD(fn), nullptr);
+}
+
+template <typename T>
+template <typename F>
+pipeline pipeline_builder<T>::sink(F&& fn, thread_pool_scheduler& pool) && {
+    return _sink(NEO_FWD(fn), &pool);
+}
+
+}  // namespace neo
@@ -0,0 +1,167 @@
+#include "./pipeline.hpp"
+
+#include "./channel.hpp"
+#include "./generator.hpp"
+#include "./thread_pool_scheduler.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+neo::generator<int> count_to(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// Split each string into its characters
+neo::generator<char> split_chars(neo::pipeline_input<std::string>& in) {
+    for (auto& s : in) {
+        for (char c : s) {
+            co_yield c;
+        }
+    }
+}
+
+// Join each pair of values
+neo::channel<std::string> join_pairs(neo::pipeline_input<char>& in) {
+    std::string acc;
+    for (char c : in) {
+        acc.push_back(c);
+        if (acc.size() == 2) {
+            co_yield std::move(acc);
+            acc.clear();
+        }
+    }
+    if (not acc.empty()) {
+        co_yield std::move(acc);
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Run a pipeline of functions") {
+    std::vector<std::string> got;
+    auto p = neo::pipeline::from([] { return count_to(1000); },
+                                 {.queue_capacity = 16, .batch_size = 4})
+                 .then([](int i) { return i * 2; })
+                 .then([](int i) { return std::to_string(i); })
+                 .sink([&](std::string s) { got.push_back(std::move(s)); });
+    CHECK(p.size() == 4);
+    p.run();
+    REQUIRE(got.size() == 1000);
+    CHECK(got.front() == "0");
+    CHECK(got.back() == "1998");
+}
+
+TEST_CASE("Run a pipeline of coroutine stages") {
+    std::vector<std::string> words = {"hello", "world", "pipeline"};
+    std::string              joined;
+    auto                     p = neo::pipeline::from(words)
+                 .then(split_chars)
+                 .then(join_pairs)
+                 .sink([&](neo::pipeline_input<std::string>& in) {
+                     for (auto& s : in) {
+                         joined += s + ",";
+                     }
+                 });
+    p.run();
+    CHECK(joined == "he,ll,ow,or,ld,pi,pe,li,ne,");
+}
+
+TEST_CASE("Run pipeline stages on a thread pool") {
+    neo::thread_pool_scheduler pool{2};
+    std::thread::id            map_thread;
+    long long                  sum = 0;
+    auto                       p   = neo::pipeline::from(count_to(10'000), pool)
+                 .then(
+                     [&](int i) {
+                         map_thread = std::this_thread::get_id();
+                         return i + 1;
+                     },
+                     pool)
+                 .sink([&](int i) { sum += i; });
+    p.run();
+    CHECK(sum == 10'000LL * 10'001 / 2);
+    CHECK(map_thread != std::this_thread::get_id());
+}
+
+TEST_CASE("A pipeline needs a pool worker for each pooled stage") {
+    neo::thread_pool_scheduler pool{1};
+    int                        n_sunk = 0;
+    auto                       p      = neo::pipeline::from(count_to(10), pool)
+                 .then([](int i) { return i; }, pool)
+                 .sink([&](int) { ++n_sunk; });
+    CHECK_THROWS_AS(p.run(), std::invalid_argument);
+    CHECK(n_sunk == 0);
+}
+
+TEST_CASE("An exception in a stage stops the pipeline") {
+    int  n_sunk = 0;
+    auto p      = neo::pipeline::from(count_to(1'000'000), {.queue_capacity = 8, .batch_size = 2})
+                 .then([](int i) {
+                     if (i == 100) {
+                         throw std::runtime_error("bad value");
+                     }
+                     return i;
+                 })
+                 .sink([&](int) { ++n_sunk; });
+    CHECK_THROWS_AS(p.run(), std::runtime_error);
+    // Everything before the failure was delivered
+    CHECK(n_sunk == 100);
+}
+
+TEST_CASE("A sink that stops early stops the pipeline") {
+    std::vector<int> got;
+    auto             p = neo::pipeline::from(count_to(1'000'000), {.queue_capacity = 8})
+                 .then([](int i) { return i * 3; })
+                 .sink([&](neo::pipeline_input<int>& in) {
+                     for (auto v : in) {
+                         got.push_back(v);
+                         if (got.size() == 5) {
+                             break;
+                         }
+                     }
+                 });
+    p.run();
+    CHECK(got == std::vector<int>{0, 3, 6, 9, 12});
+}
+
+TEST_CASE("Pipeline throughput", "[.][benchmark]") {
+    // Four stages that each do a little work per value
+    const int n     = 5'000'000;
+    auto      work  = [](std::uint64_t x) {
+        for (int i = 0; i < 50; ++i) {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        return x;
+    };
+    std::uint64_t serial = 0;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        serial ^= work(work(work(static_cast<std::uint64_t>(i))));
+    }
+    auto serial_dur = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t parallel = 0;
+    start                  = std::chrono::steady_clock::now();
+    neo::pipeline::from([&] { return count_to(n); })
+        .then([&](int i) { return work(static_cast<std::uint64_t>(i)); })
+        .then(work)
+        .then(work)
+        .sink([&](std::uint64_t x) { parallel ^= x; })
+        .run();
+    auto parallel_dur = std::chrono::steady_clock::now() - start;
+    CHECK(serial == parallel);
+    std::printf("serial: %6.2f ns per value, pipeline: %6.2f ns per value\n",
+                std::chrono::duration<double, std::nano>(serial_dur).count() / n,
+                std::chrono::duration<double, std::nano>(parallel_dur).count() / n);
+}
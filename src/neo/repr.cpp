@@ -2,7 +2,42 @@
 
 #include <ostream>
 
+using namespace neo;
+
 void neo::repr_detail::item_repr_base::write_ostream(std::ostream& out) const noexcept {
-    auto str = this->string();
-    out.write(str.data(), static_cast<std::streamsize>(str.size()));
+    neo::repr_into(out, *this);
+}
+
+void neo::repr_detail::repr_stream::flush() noexcept {
+    auto part = std::string_view(*buffer);
+    if (part.size() > max_size - n_written) {
+        part      = part.substr(0, max_size - n_written);
+        truncated = true;
+    }
+    write(sink, part);
+    n_written += part.size();
+    if (truncated) {
+        write(sink, "...");
+    }
+    buffer->clear();
+}
+
+void neo::repr_detail::repr_into_impl(repr_stream& stream, const item_repr_base& item) noexcept {
+    stream.buffer->reserve(stream.chunk_size);
+    auto prev      = tl_repr_stream;
+    tl_repr_stream = &stream;
+    item.append_to(*stream.buffer);
+    if (not stream.truncated) {
+        stream.flush();
+    }
+    tl_repr_stream = prev;
+}
+
+bool neo::repr_into(std::ostream& out, const repr_detail::item_repr_base& item, repr_limits limits) {
+    return neo::repr_into(
+        [&](std::string_view part) {
+            out.write(part.data(), static_cast<std::streamsize>(part.size()));
+        },
+        item,
+        limits);
 }
@@ -4,11 +4,15 @@
 #include "./concepts.hpp"
 #include "./ufmt.hpp"
 
+#include <algorithm>
 #include <charconv>
 #include <cinttypes>
+#include <cstddef>
 #include <iosfwd>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 /**
@@ -75,8 +79,50 @@ concept has_repr_builtin =   //
 template <typename T>
 concept reprable_impl = has_repr_builtin<remove_cvref_t<T>> || has_adl_do_repr<T>;
 
+/**
+ * @brief State of an in-progress `repr_into()`.
+ *
+ * repr() output is accumulated in `buffer`, which is periodically handed off to
+ * the sink and cleared. Because nested repr()s are appended to the same string via
+ * `ufmt_append`, the active stream is found through a thread-local pointer rather
+ * than being passed down through every writer.
+ */
+struct repr_stream {
+    /// The buffer into which the repr() is being written
+    std::string* buffer;
+    /// Pass a chunk of output to the sink
+    void (*write)(void* sink, std::string_view) noexcept;
+    /// The sink object
+    void* sink;
+    /// Flush the buffer when it grows to this size
+    std::size_t chunk_size;
+    /// The maximum number of characters to emit
+    std::size_t max_size;
+    /// The number of characters that have been passed to the sink
+    std::size_t n_written = 0;
+    /// Set once the output has hit `max_size`. Further output is discarded.
+    bool truncated = false;
+
+    /// Pass the content of the buffer to the sink, truncating if necessary
+    void flush() noexcept;
+
+    /// Called after content is appended to `buffer`
+    void after_append() noexcept {
+        if (truncated) {
+            buffer->clear();
+        } else if (buffer->size() >= chunk_size || n_written + buffer->size() > max_size) {
+            flush();
+        }
+    }
+};
+
+/// The repr_into() that is active on the current thread, if any
+inline thread_local repr_stream* tl_repr_stream = nullptr;
+
 struct item_repr_base {
     virtual std::string string() const noexcept = 0;
+    /// Append the representation to the given string
+    virtual void append_to(std::string& out) const noexcept = 0;
 
 private:
     void write_ostream(std::ostream& o) const noexcept;
@@ -94,6 +140,7 @@ struct fallback_repr : item_repr_base {
         : _fallback(NEO_MOVE(s)) {}
 
     std::string           string() const noexcept { return _fallback; }
+    void                  append_to(std::string& out) const noexcept { out.append(_fallback); }
     constexpr friend void ufmt_append(auto& into, fallback_repr const& self) noexcept {
         into.append(self._fallback);
     }
@@ -111,7 +158,26 @@ public:
 
     template <formattable... Ts>
     constexpr void append(std::string_view fmt_str, const Ts&... args) const {
-        neo::ufmt_into(*_out, fmt_str, args...);
+        auto stream = tl_repr_stream;
+        if (stream and stream->buffer == _out) {
+            if (stream->truncated) {
+                return;
+            }
+            neo::ufmt_into(*_out, fmt_str, args...);
+            stream->after_append();
+        } else {
+            neo::ufmt_into(*_out, fmt_str, args...);
+        }
+    }
+
+    /**
+     * @brief Determine whether any further output will be discarded because a size limit
+     * given to `repr_into()` has been reached. Representations of large objects may
+     * use this to stop early.
+     */
+    bool exhausted() const noexcept {
+        auto stream = tl_repr_stream;
+        return stream and stream->buffer == _out and stream->truncated;
     }
 
     template <reprable_impl T>
@@ -219,6 +285,7 @@ template <reprable_impl T>
 struct type_repr : item_repr_base {
     /// Realize the type's repr() as a std::string
     std::string string() const noexcept override { return neo::ufmt("{}", *this); }
+    void        append_to(std::string& out) const noexcept override { ufmt_append(out, *this); }
 
     /// Serialize the repr() of the type to a ufmt() string
     friend void ufmt_append(std::string& out, type_repr) noexcept {
@@ -249,6 +316,7 @@ struct value_repr : item_repr_base {
 
     /// Realize the repr() of the given value as a string
     std::string string() const noexcept override { return neo::ufmt("{}", *this); }
+    void        append_to(std::string& out) const noexcept override { ufmt_append(out, *this); }
 
     /// Append the repr() of the value to the given ufmt() string
     constexpr friend void ufmt_append(std::string& out, value_repr self) noexcept {
@@ -346,6 +414,78 @@ struct repr_fn {
  */
 inline constexpr repr_fn repr{};
 
+/**
+ * @brief Options for `repr_into()`
+ */
+struct repr_limits {
+    /// The maximum number of characters of output. If the representation is longer, the output is
+    /// cut short and followed by "..."
+    std::size_t max_size = std::string::npos;
+    /// The size of the chunks that are passed to the sink
+    std::size_t chunk_size = 4096;
+};
+
+/**
+ * @brief A sink for `repr_into()` that writes into a fixed-size character buffer.
+ *
+ * Output that does not fit in the buffer is discarded.
+ */
+class repr_buffer_sink {
+    std::span<char> _buf;
+    std::size_t     _size = 0;
+
+public:
+    explicit repr_buffer_sink(std::span<char> buf) noexcept
+        : _buf(buf) {}
+
+    void operator()(std::string_view part) noexcept {
+        const auto n = (std::min)(part.size(), _buf.size() - _size);
+        part.copy(_buf.data() + _size, n);
+        _size += n;
+    }
+
+    /// Obtain a view of the characters that have been written to the buffer
+    std::string_view view() const noexcept { return std::string_view(_buf.data(), _size); }
+};
+
+namespace repr_detail {
+
+void repr_into_impl(repr_stream& stream, const item_repr_base& item) noexcept;
+
+}  // namespace repr_detail
+
+/**
+ * @brief Incrementally write a representation into the given sink.
+ *
+ * Rather than generating the entire representation as a single string, the output is
+ * passed to `sink` in pieces of approximately `limits.chunk_size` characters.
+ *
+ * @param sink An invocable object that accepts `std::string_view`s of output. Invocations are
+ * made in the order of the output.
+ * @param item The result of a call to `repr()`, `repr_value()`, or `repr_type()`
+ * @param limits Limits on the output size.
+ * @return true If the whole representation was written, false if it was truncated.
+ */
+template <std::invocable<std::string_view> Sink>
+bool repr_into(Sink&& sink, const repr_detail::item_repr_base& item, repr_limits limits = {}) {
+    using sink_type = remove_reference_t<Sink>;
+    std::string              buf;
+    repr_detail::repr_stream stream{
+        &buf,
+        [](void* s, std::string_view part) noexcept { (*static_cast<sink_type*>(s))(part); },
+        const_cast<void*>(static_cast<const void*>(NEO_ADDRESSOF(sink))),
+        limits.chunk_size,
+        limits.max_size,
+    };
+    repr_detail::repr_into_impl(stream, item);
+    return not stream.truncated;
+}
+
+/**
+ * @brief Write a representation to the given ostream incrementally
+ */
+bool repr_into(std::ostream& out, const repr_detail::item_repr_base& item, repr_limits limits = {});
+
 namespace repr_detail {
 
 template <reprable_impl T>
@@ -754,7 +894,7 @@ struct repr_builtin<Map> {
             auto& map  = *value;
             auto  iter = std::ranges::begin(map);
             auto  end  = std::ranges::end(map);
-            while (iter != end) {
+            while (iter != end and not out.exhausted()) {
                 auto& pair                = *iter;
                 const auto& [key, mapped] = pair;
                 out.append("[{} => {}]", repr_value(key), repr_value(mapped));
@@ -790,7 +930,7 @@ struct repr_builtin<R> {
         if (value) {
             out.append("{");
             auto end = std::ranges::cend(*value);
-            for (auto it = std::ranges::cbegin(*value); it != end; ++it) {
+            for (auto it = std::ranges::cbegin(*value); it != end and not out.exhausted(); ++it) {
                 out.append("{}", repr_value(*it, "?"));
                 if (std::next(it) != end) {
                     out.append(", ");
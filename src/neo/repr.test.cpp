@@ -4,7 +4,9 @@
 #include <filesystem>
 #include <map>
 #include <optional>
+#include <sstream>
 #include <string_view>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -127,3 +129,47 @@ TEST_CASE("repr() a filesystem path") {
     auto expect = neo::ufmt("path{{}}", neo::repr_value(cwd.string()));
     CHECK(rep == expect);
 }
+
+TEST_CASE("Stream a repr() into a sink") {
+    std::vector<int> vec(1000, 7);
+    auto             expect = neo::repr(vec).string();
+
+    std::string              out;
+    std::vector<std::size_t> chunk_sizes;
+    CHECK(neo::repr_into(
+        [&](std::string_view part) {
+            chunk_sizes.push_back(part.size());
+            out.append(part);
+        },
+        neo::repr(vec),
+        {.chunk_size = 256}));
+    CHECK(out == expect);
+    CHECK(chunk_sizes.size() > 1);
+    for (auto size : chunk_sizes) {
+        CHECK(size < 512);
+    }
+
+    std::ostringstream strm;
+    CHECK(neo::repr_into(strm, neo::repr_value(std::vector<int>{1, 2, 3})));
+    CHECK(strm.str() == "{1, 2, 3}");
+}
+
+TEST_CASE("Truncate a repr()") {
+    std::vector<int> vec(1'000'000, 42);
+    std::string      out;
+    CHECK_FALSE(neo::repr_into([&](std::string_view part) { out.append(part); },
+                               neo::repr(vec),
+                               {.max_size = 20}));
+    CHECK(out == "vector<int32>{42, 42...");
+
+    out.clear();
+    CHECK(neo::repr_into([&](std::string_view part) { out.append(part); },
+                         neo::repr_value(vec[0]),
+                         {.max_size = 2}));
+    CHECK(out == "42");
+
+    char                   buf[8];
+    neo::repr_buffer_sink  sink{buf};
+    neo::repr_into(sink, neo::repr_value(std::string("Hello, world!")));
+    CHECK(sink.view() == "\"Hello, ");
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "./assert.hpp"
+#include "./concepts.hpp"
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./storage.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace neo {
+
+/**
+ * @brief A bounded single-producer/single-consumer queue that hands values over in batches.
+ *
+ * The producer stages values in the ring buffer and only publishes them to the consumer once
+ * `batch_size()` values are staged, or when `flush()` or `close()` is called. Likewise, the
+ * consumer only hands free slots back to the producer once per batch. This keeps the two
+ * threads from contending on the same cache lines for every value.
+ *
+ * `push()` blocks while the queue is full, and `pop()` blocks while the queue is empty. Before
+ * blocking, each side publishes what it has staged, so a batch never waits for itself.
+ *
+ * Either side may end the exchange: The producer calls `close()` once it has no more values,
+ * after which the consumer receives the remaining values and then `nullopt`. The consumer
+ * calls `cancel()` if it will not receive any more values, after which `push()` fails.
+ *
+ * Only one thread may act as the producer, and only one thread as the consumer, at a time.
+ */
+template <typename T>
+class spsc_queue {
+    // Set in a published index when its side has closed/cancelled the queue
+    static constexpr std::size_t closed_bit = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+
+    // The published indices are on their own cache lines
+    alignas(64) std::atomic<std::size_t> _head{0};
+    alignas(64) std::atomic<std::size_t> _tail{0};
+
+    // Consumer state
+    alignas(64) std::size_t _read = 0;
+    std::size_t _released_head    = 0;
+    std::size_t _tail_cache       = 0;
+
+    // Producer state
+    alignas(64) std::size_t _write = 0;
+    std::size_t _published_tail    = 0;
+    std::size_t _head_cache        = 0;
+
+    alignas(64) std::size_t _mask;
+    std::size_t                       _batch;
+    std::unique_ptr<storage_for<T>[]> _slots;
+
+    // The number of times to re-check an index before sleeping on it
+    static constexpr int spin_count = 64;
+
+    static std::size_t _wait_change(std::atomic<std::size_t>& idx, std::size_t old) noexcept {
+        for (int i = 0; i < spin_count; ++i) {
+            auto cur = idx.load(std::memory_order_acquire);
+            if (cur != old) {
+                return cur;
+            }
+        }
+        idx.wait(old, std::memory_order_acquire);
+        return idx.load(std::memory_order_acquire);
+    }
+
+    // Wait until there is room for another value. Returns false if the consumer cancelled.
+    bool _wait_for_room() noexcept {
+        auto h = _head.load(std::memory_order_acquire);
+        for (;;) {
+            if (h & closed_bit) {
+                return false;
+            }
+            _head_cache = h;
+            if (_write - h < capacity()) {
+                return true;
+            }
+            flush();
+            h = _wait_change(_head, h);
+        }
+    }
+
+    // Wait until there is another value. Returns false if the producer closed the queue.
+    bool _wait_for_value() noexcept {
+        auto t = _tail.load(std::memory_order_acquire);
+        for (;;) {
+            _tail_cache = t & ~closed_bit;
+            if (_read != _tail_cache) {
+                return true;
+            }
+            if (t & closed_bit) {
+                return false;
+            }
+            _release();
+            t = _wait_change(_tail, t);
+        }
+    }
+
+    // Hand the slots we have consumed back to the producer
+    void _release() noexcept {
+        if (_released_head == _read) {
+            return;
+        }
+        _released_head = _read;
+        _head.store(_read, std::memory_order_release);
+        _head.notify_one();
+    }
+
+    T _take() noexcept(nothrow_constructible_from<T, T>) {
+        auto& slot = _slots[_read & _mask];
+        T     ret  = NEO_MOVE(slot).get();
+        slot.destroy();
+        ++_read;
+        if (_read - _released_head >= _batch) {
+            _release();
+        }
+        return ret;
+    }
+
+public:
+    /**
+     * @brief Create a queue that can hold at least `capacity` values.
+     *
+     * @param capacity The capacity of the ring buffer. Rounded up to a power of two.
+     * @param batch_size The number of values that are handed over at once. Clamped to the
+     * capacity.
+     */
+    explicit spsc_queue(std::size_t capacity, std::size_t batch_size = 1) {
+        neo_assert(expects, capacity > 0, "spsc_queue capacity must be non-zero");
+        neo_assert(expects, batch_size > 0, "spsc_queue batch size must be non-zero");
+        capacity = std::bit_ceil(capacity);
+        _mask    = capacity - 1;
+        _batch   = batch_size < capacity ? batch_size : capacity;
+        _slots   = std::make_unique<storage_for<T>[]>(capacity);
+    }
+
+    spsc_queue(const spsc_queue&)            = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue() {
+        for (; _read != _write; ++_read) {
+            _slots[_read & _mask].destroy();
+        }
+    }
+
+    /// The maximum number of values the queue can hold
+    std::size_t capacity() const noexcept { return _mask + 1; }
+
+    /// The number of values that are handed over at once
+    std::size_t batch_size() const noexcept { return _batch; }
+
+    /**
+     * @brief [Producer] Construct a value in the queue, blocking while the queue is full.
+     *
+     * @return false If the consumer has cancelled the queue. The value is discarded.
+     */
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        if (_write - _head_cache >= capacity() and not _wait_for_room()) {
+            return false;
+        }
+        _slots[_write & _mask].construct(NEO_FWD(args)...);
+        ++_write;
+        if (_write - _published_tail >= _batch) {
+            flush();
+            // Notice a cancellation at least once per batch
+            if (_head.load(std::memory_order_relaxed) & closed_bit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// [Producer] Push a value. See `emplace()`.
+    bool push(T&& value) { return emplace(NEO_MOVE(value)); }
+    bool push(const T& value) { return emplace(value); }
+
+    /// [Producer] Publish the staged values to the consumer
+    void flush() noexcept {
+        if (_published_tail == _write) {
+            return;
+        }
+        _published_tail = _write;
+        _tail.store(_write, std::memory_order_release);
+        _tail.notify_one();
+    }
+
+    /// [Producer] Publish the staged values, and signal that there will be no more
+    void close() noexcept {
+        _published_tail = _write;
+        _tail.store(_write | closed_bit, std::memory_order_release);
+        _tail.notify_one();
+    }
+
+    /**
+     * @brief [Consumer] Take the next value, blocking while the queue is empty.
+     *
+     * @return The value, or `nullopt` if the queue is closed and has no more values.
+     */
+    optional<T> pop() {
+        if (_read == _tail_cache and not _wait_for_value()) {
+            return nullopt;
+        }
+        return _take();
+    }
+
+    /**
+     * @brief [Consumer] Take the next value if one has been published.
+     *
+     * @return The value, or `nullopt` if the queue is empty or closed.
+     */
+    optional<T> try_pop() {
+        if (_read == _tail_cache) {
+            _tail_cache = _tail.load(std::memory_order_acquire) & ~closed_bit;
+            if (_read == _tail_cache) {
+                return nullopt;
+            }
+        }
+        return _take();
+    }
+
+    /// [Consumer] Signal that no more values will be taken. Unblocks a waiting producer.
+    void cancel() noexcept {
+        _released_head = _read;
+        _head.store(_read | closed_bit, std::memory_order_release);
+        _head.notify_one();
+    }
+};
+
+}  // namespace neo
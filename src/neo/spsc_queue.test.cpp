@@ -0,0 +1,73 @@
+#include "./spsc_queue.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+TEST_CASE("Push and pop on one thread") {
+    neo::spsc_queue<std::string> q{4, 2};
+    CHECK(q.capacity() == 4);
+    CHECK(q.batch_size() == 2);
+    CHECK(q.push("a"));
+    // Not published until the batch is full
+    CHECK_FALSE(q.try_pop().has_value());
+    CHECK(q.push("b"));
+    CHECK(q.try_pop() == "a");
+    CHECK(q.try_pop() == "b");
+    CHECK(q.push("c"));
+    q.close();
+    CHECK(q.pop() == "c");
+    CHECK_FALSE(q.pop().has_value());
+}
+
+TEST_CASE("Values left in the queue are destroyed") {
+    auto p = std::make_shared<int>(3);
+    {
+        neo::spsc_queue<std::shared_ptr<int>> q{8};
+        q.push(p);
+        q.push(p);
+        CHECK(p.use_count() == 3);
+    }
+    CHECK(p.use_count() == 1);
+}
+
+TEST_CASE("Transfer values between threads with backpressure") {
+    const int            n = 200'000;
+    neo::spsc_queue<int> q{64, 16};
+    bool                 all_pushed = true;
+    std::thread          producer{[&] {
+        for (int i = 0; i < n; ++i) {
+            all_pushed = all_pushed and q.push(i);
+        }
+        q.close();
+    }};
+    long long sum      = 0;
+    int       expected = 0;
+    while (auto v = q.pop()) {
+        CHECK(*v == expected);
+        ++expected;
+        sum += *v;
+    }
+    producer.join();
+    CHECK(all_pushed);
+    CHECK(expected == n);
+    CHECK(sum == (long long)n * (n - 1) / 2);
+}
+
+TEST_CASE("Cancel a queue from the consumer") {
+    neo::spsc_queue<int> q{8, 4};
+    std::thread          producer{[&] {
+        int i = 0;
+        while (q.push(i++)) {
+        }
+        q.close();
+    }};
+    for (int i = 0; i < 100; ++i) {
+        CHECK(q.pop() == i);
+    }
+    // The producer is blocked on a full queue, or soon will be
+    q.cancel();
+    producer.join();
+}
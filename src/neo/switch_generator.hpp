@@ -0,0 +1,123 @@
+#pragma once
+
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./switch_coro.hpp"
+#include "./type_traits.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+namespace neo {
+
+/**
+ * @brief A CRTP base that turns a switch-coroutine state machine into an input range.
+ *
+ * The derived class stores its own loop state as regular members, and implements a
+ * `void step()` member function using `NEO_CORO_BEGIN`/`NEO_CORO_YIELD`/`NEO_CORO_END`
+ * with the inherited `coro_state` member. Each `NEO_CORO_YIELD` should pass the result
+ * of `this->yield(value)`:
+ *
+ * ```
+ * struct count_to : neo::switch_generator<count_to, int> {
+ *     int i = 0, n;
+ *     explicit count_to(int n) : n(n) {}
+ *
+ *     void step() {
+ *         NEO_CORO_BEGIN(coro_state);
+ *         for (i = 0; i < n; ++i) {
+ *             NEO_CORO_YIELD(yield(i));
+ *         }
+ *         NEO_CORO_END;
+ *     }
+ * };
+ * ```
+ *
+ * Unlike `generator<T>`, there is no coroutine frame to allocate: All state lives
+ * inside the derived object. Local variables of `step()` do not survive a yield, so any
+ * state that must persist must be a member.
+ *
+ * The object must not be moved or copied while it is being iterated, since iterators
+ * refer to it.
+ *
+ * @tparam Derived The derived class, which implements `step()`
+ * @tparam T The type of values that are yielded. May be a reference type.
+ */
+template <typename Derived, typename T>
+class switch_generator : public std::ranges::view_interface<Derived> {
+    // The most-recently yielded value
+    optional<T> _current;
+
+protected:
+    /// The resume point of the state machine. Pass this to `NEO_CORO_BEGIN`.
+    int coro_state = 0;
+
+    /**
+     * @brief Set the value that is produced by the current `NEO_CORO_YIELD`.
+     *
+     * For a reference type `T`, the referred-to object must remain alive until the next
+     * call to `step()`.
+     */
+    template <typename U>
+        requires constructible_from<T, U>
+    constexpr void yield(U&& u) noexcept(nothrow_constructible_from<T, U>) {
+        _current.emplace(NEO_FWD(u));
+    }
+
+private:
+    constexpr Derived& _self() noexcept { return static_cast<Derived&>(*this); }
+
+    constexpr void _advance() {
+        _self().step();
+        if (NEO_CORO_IS_FINISHED(coro_state)) {
+            _current.reset();
+        }
+    }
+
+public:
+    class iterator {
+        switch_generator* _gen = nullptr;
+
+        friend switch_generator;
+        constexpr explicit iterator(switch_generator* g) noexcept
+            : _gen(g) {}
+
+    public:
+        constexpr iterator() = default;
+
+        using iterator_category = std::input_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = remove_cvref_t<T>;
+        using reference         = add_rvalue_reference_t<T>;
+
+        [[nodiscard]] constexpr bool operator==(std::default_sentinel_t) const noexcept {
+            return NEO_CORO_IS_FINISHED(_gen->coro_state);
+        }
+
+        [[nodiscard]] constexpr reference operator*() const noexcept {
+            return static_cast<reference>(*_gen->_current);
+        }
+
+        constexpr iterator& operator++() {
+            _gen->_advance();
+            return *this;
+        }
+
+        constexpr void operator++(int) { ++*this; }
+    };
+
+    /**
+     * @brief Run the state machine until it yields its first value.
+     *
+     * The behavior of calling this function more than once is undefined.
+     */
+    [[nodiscard]] constexpr iterator begin() {
+        _advance();
+        return iterator{this};
+    }
+
+    [[nodiscard]] constexpr std::default_sentinel_t end() const noexcept { return {}; }
+};
+
+}  // namespace neo
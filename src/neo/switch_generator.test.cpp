@@ -0,0 +1,117 @@
+#include "./switch_generator.hpp"
+
+#include "./generator.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct count_to : neo::switch_generator<count_to, int> {
+    int i = 0;
+    int n;
+
+    explicit count_to(int n)
+        : n(n) {}
+
+    void step() {
+        NEO_CORO_BEGIN(coro_state);
+        for (i = 0; i < n; ++i) {
+            NEO_CORO_YIELD(yield(i));
+        }
+        NEO_CORO_END;
+    }
+};
+
+/// Yields a reference to each string in a vector, skipping empty ones
+struct non_empty : neo::switch_generator<non_empty, std::string&> {
+    std::vector<std::string>& strings;
+    std::size_t               idx = 0;
+
+    explicit non_empty(std::vector<std::string>& s)
+        : strings(s) {}
+
+    void step() {
+        NEO_CORO_BEGIN(coro_state);
+        for (idx = 0; idx < strings.size(); ++idx) {
+            if (strings[idx].empty()) {
+                continue;
+            }
+            NEO_CORO_YIELD(yield(strings[idx]));
+        }
+        NEO_CORO_END;
+    }
+};
+
+}  // namespace
+
+static_assert(std::input_iterator<count_to::iterator>);
+static_assert(std::ranges::input_range<count_to>);
+static_assert(std::ranges::view<count_to>);
+
+TEST_CASE("Iterate a switch_generator") {
+    std::vector<int> got;
+    for (int v : count_to(5)) {
+        got.push_back(v);
+    }
+    CHECK(got == std::vector<int>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("Empty switch_generator") {
+    auto gen = count_to(0);
+    CHECK(gen.begin() == gen.end());
+}
+
+TEST_CASE("switch_generator yielding references") {
+    std::vector<std::string> strings = {"foo", "", "bar", "", ""};
+    for (std::string& s : non_empty(strings)) {
+        s += "!";
+    }
+    CHECK(strings == std::vector<std::string>{"foo!", "", "bar!", "", ""});
+}
+
+TEST_CASE("Compose a switch_generator with range adaptors") {
+    std::vector<int> got;
+    for (int v : count_to(10) | std::views::filter([](int i) { return i % 3 == 0; })
+             | std::views::transform([](int i) { return i * 2; })) {
+        got.push_back(v);
+    }
+    CHECK(got == std::vector<int>{0, 6, 12, 18});
+}
+
+namespace {
+
+neo::generator<int> count_gen(int n) {
+    for (int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+}  // namespace
+
+TEST_CASE("switch_generator throughput", "[.][benchmark]") {
+    const int n_values = 10'000'000;
+    auto      measure  = [&](const char* name, auto make_gen) {
+        auto      start = std::chrono::steady_clock::now();
+        long long sum   = 0;
+        // Create many short-lived generators, so that the cost of creating the state is visible
+        for (int n = 0; n < n_values; n += 10) {
+            for (int v : make_gen(10)) {
+                sum += v;
+            }
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        CHECK(sum == 45LL * (n_values / 10));
+        std::printf("%-20s %6.2f ns per value\n",
+                    name,
+                    std::chrono::duration<double, std::nano>(dur).count() / n_values);
+    };
+    measure("neo::generator", count_gen);
+    measure("switch_generator", [](int n) { return count_to(n); });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "./await.hpp"
+#include "./await_driver.hpp"
+#include "./fwd.hpp"
+
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+
+namespace neo {
+
+namespace sync_wait_detail {
+
+/// Blocking state of a sync_wait. Lives on the stack of the waiting thread.
+struct waiter {
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    done = false;
+
+    void set() noexcept {
+        // Notify while holding the lock, since the waiter is destroyed as soon as it wakes
+        std::scoped_lock lk{mtx};
+        done = true;
+        cv.notify_one();
+    }
+
+    void wait() noexcept {
+        std::unique_lock lk{mtx};
+        cv.wait(lk, [&] { return done; });
+    }
+};
+
+/// Wakes the waiter when the driver of a sync_wait finishes
+struct notify_waiter {
+    waiter* _waiter = nullptr;
+
+    std::coroutine_handle<> operator()() const noexcept {
+        _waiter->set();
+        return std::noop_coroutine();
+    }
+};
+
+}  // namespace sync_wait_detail
+
+/**
+ * @brief Block the calling thread until the given awaitable completes, and return its result.
+ *
+ * The awaitable is awaited from within a new coroutine that is started on the calling thread.
+ * If the awaitable suspends, the calling thread blocks until another thread resumes the
+ * coroutine and it completes.
+ *
+ * @param a Any awaitable object
+ * @return The result of the `co_await` expression on `a`. If the result is a reference,
+ * returns that reference. If the `co_await` throws, the exception is rethrown.
+ *
+ * @note Do not call this from a thread that must run to complete the awaitable (e.g. a worker
+ * thread of the scheduler that the awaitable depends upon).
+ */
+template <awaitable A>
+await_result_t<A> sync_wait(A&& a) {
+    using result_type = await_result_t<A>;
+    sync_wait_detail::waiter st;
+    auto d = await_driver_detail::make_driver<result_type, sync_wait_detail::notify_waiter>(
+        NEO_FWD(a));
+    d.completion()._waiter = &st;
+    d.start();
+    st.wait();
+    return d.take();
+}
+
+}  // namespace neo
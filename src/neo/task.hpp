@@ -0,0 +1,165 @@
+#pragma once
+
+#include "./concepts.hpp"
+#include "./frame_alloc.hpp"
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./type_traits.hpp"
+
+#include <coroutine>
+#include <exception>
+
+namespace neo {
+
+template <typename T = void>
+class task;
+
+namespace task_detail {
+
+/// Common base of the task promise types
+class promise_base : public frame_alloc_promise_base_for<"neo::task"> {
+    // The coroutine that is awaiting the task, and should be resumed when the task completes
+    std::coroutine_handle<> _continuation = std::noop_coroutine();
+    // The exception that escaped the task body
+    std::exception_ptr _exception;
+
+    template <typename>
+    friend class neo::task;
+
+    struct final_awaiter {
+        constexpr bool await_ready() const noexcept { return false; }
+        // Symmetric transfer to whomever awaited us
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> co) const noexcept {
+            return co.promise()._continuation;
+        }
+        void await_resume() const noexcept {}
+    };
+
+public:
+    // Tasks are lazy: They do not begin executing until they are awaited
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter       final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { _exception = std::current_exception(); }
+
+    void rethrow_if_exception() const {
+        if (_exception) {
+            std::rethrow_exception(_exception);
+        }
+    }
+};
+
+template <typename T>
+class promise : public promise_base {
+    optional<T> _value;
+
+public:
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+        requires convertible_to<U, T>
+    void return_value(U&& u) noexcept(nothrow_constructible_from<T, U>) {
+        _value.emplace(NEO_FWD(u));
+    }
+
+    T take_result() {
+        this->rethrow_if_exception();
+        return static_cast<add_rvalue_reference_t<T>>(*_value);
+    }
+};
+
+template <>
+class promise<void> : public promise_base {
+public:
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void take_result() const { this->rethrow_if_exception(); }
+};
+
+}  // namespace task_detail
+
+/**
+ * @brief A lazily-started coroutine type that produces a single value when awaited.
+ *
+ * The coroutine body does not begin until the task is `co_await`ed. When the
+ * body finishes, the awaiting coroutine is resumed via symmetric transfer, and
+ * the result of the `co_await` is the value given to `co_return` (or the exception
+ * that escaped the coroutine is rethrown).
+ *
+ * The coroutine frame is allocated by `frame_alloc_promise_base`, so a task
+ * coroutine may accept a leading `std::allocator_arg_t, Alloc` pair of parameters.
+ *
+ * @tparam T The result type of the task. May be `void` or a reference type.
+ */
+template <typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = task_detail::promise<T>;
+
+private:
+    using handle_type = std::coroutine_handle<promise_type>;
+    handle_type _coro;
+
+    friend promise_type;
+    explicit task(handle_type h) noexcept
+        : _coro(h) {}
+
+    struct awaiter {
+        handle_type _coro;
+
+        bool await_ready() const noexcept { return _coro.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) const noexcept {
+            _coro.promise()._continuation = cont;
+            return _coro;
+        }
+
+        T await_resume() const { return _coro.promise().take_result(); }
+    };
+
+public:
+    task(task&& o) noexcept
+        : _coro(o._coro) {
+        o._coro = nullptr;
+    }
+
+    task& operator=(task&& o) noexcept {
+        if (_coro) {
+            _coro.destroy();
+        }
+        _coro   = o._coro;
+        o._coro = nullptr;
+        return *this;
+    }
+
+    ~task() {
+        if (_coro) {
+            _coro.destroy();
+        }
+    }
+
+    /// Determine whether the task has run to completion
+    bool done() const noexcept { return _coro.done(); }
+
+    /**
+     * @brief Start or continue the task and wait for its result.
+     *
+     * @pre The task must not already be awaited by another coroutine.
+     */
+    awaiter operator co_await() const& noexcept { return awaiter{_coro}; }
+    awaiter operator co_await() && noexcept { return awaiter{_coro}; }
+};
+
+template <typename T>
+task<T> task_detail::promise<T>::get_return_object() noexcept {
+    return task<T>{std::coroutine_handle<promise>::from_promise(*this)};
+}
+
+inline task<void> task_detail::promise<void>::get_return_object() noexcept {
+    return task<void>{std::coroutine_handle<promise>::from_promise(*this)};
+}
+
+}  // namespace neo
@@ -0,0 +1,73 @@
+#include "./task.hpp"
+
+#include "./sync_wait.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+neo::task<int> get_int() { co_return 21; }
+
+neo::task<int> add_ints() {
+    auto a = co_await get_int();
+    auto b = co_await get_int();
+    co_return a + b;
+}
+
+neo::task<> set_flag(bool& flag) {
+    flag = true;
+    co_return;
+}
+
+neo::task<std::string> throws() {
+    throw std::runtime_error("oops");
+    co_return "unreachable";
+}
+
+int            global_int = 0;
+neo::task<int&> get_ref() { co_return global_int; }
+
+neo::task<std::unique_ptr<int>> get_move_only() { co_return std::make_unique<int>(1729); }
+
+neo::task<int> deep(int n) {
+    if (n == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await deep(n - 1);
+}
+
+}  // namespace
+
+static_assert(neo::awaitable<neo::task<int>>);
+static_assert(std::same_as<neo::await_result_t<neo::task<int>>, int>);
+static_assert(std::same_as<neo::await_result_t<neo::task<int&>>, int&>);
+
+TEST_CASE("Await a task") { CHECK(neo::sync_wait(add_ints()) == 42); }
+
+TEST_CASE("Tasks are lazy") {
+    bool flag = false;
+    auto t    = set_flag(flag);
+    CHECK_FALSE(flag);
+    neo::sync_wait(t);
+    CHECK(flag);
+    CHECK(t.done());
+}
+
+TEST_CASE("Task exceptions propagate") {
+    CHECK_THROWS_AS(neo::sync_wait(throws()), std::runtime_error);
+}
+
+TEST_CASE("Reference and move-only results") {
+    int& r = neo::sync_wait(get_ref());
+    CHECK(&r == &global_int);
+    auto p = neo::sync_wait(get_move_only());
+    CHECK(*p == 1729);
+}
+
+TEST_CASE("Nested tasks") {
+    CHECK(neo::sync_wait(deep(1000)) == 1000);
+}
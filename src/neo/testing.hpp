@@ -2,6 +2,9 @@
 
 #include <neo/meta.hpp>
 
+#include <cstddef>
+#include <memory>
+
 namespace neo::testing {
 
 struct asserter {
@@ -37,4 +40,40 @@ struct [[maybe_unused]] cx_test_case_foreach {
     }
 };
 
+/// The counts of a `counting_allocator`
+struct alloc_stats {
+    int n_allocs   = 0;
+    int n_deallocs = 0;
+};
+
+/**
+ * @brief An allocator that counts its allocations and deallocations in an `alloc_stats`, and
+ * otherwise behaves like `std::allocator`.
+ */
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    alloc_stats* stats;
+
+    explicit counting_allocator(alloc_stats& s) noexcept
+        : stats(&s) {}
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& o) noexcept
+        : stats(o.stats) {}
+
+    T* allocate(std::size_t n) {
+        ++stats->n_allocs;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        ++stats->n_deallocs;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const counting_allocator&) const = default;
+};
+
 }  // namespace neo::testing
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "./thread_pool_scheduler.hpp"
+
+#include "./assert.hpp"
+
+using namespace neo;
+using sched_detail::work_stealing_deque;
+
+namespace {
+
+/// The worker that is running on the current thread, if any
+struct current_worker {
+    const thread_pool_scheduler*       sched = nullptr;
+    sched_detail::work_stealing_deque* deque = nullptr;
+    std::size_t                        index = 0;
+};
+
+thread_local current_worker tl_current_worker;
+
+/// A small xorshift generator used to pick victims to steal from
+std::uint32_t next_random(std::uint32_t& state) noexcept {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+}  // namespace
+
+work_stealing_deque::work_stealing_deque(std::int64_t initial_capacity) {
+    neo_assert(expects,
+               initial_capacity > 0 && (initial_capacity & (initial_capacity - 1)) == 0,
+               "Work-stealing deque capacity must be a power of two",
+               initial_capacity);
+    _buffers.push_back(std::make_unique<buffer>(initial_capacity));
+    _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+}
+
+work_stealing_deque::buffer*
+work_stealing_deque::_grow(buffer* old, std::int64_t top, std::int64_t bottom) {
+    auto bigger = std::make_unique<buffer>(old->capacity * 2);
+    for (auto i = top; i != bottom; ++i) {
+        bigger->put(i, old->get(i));
+    }
+    auto ret = bigger.get();
+    _buffers.push_back(std::move(bigger));
+    _buffer.store(ret, std::memory_order_release);
+    return ret;
+}
+
+void work_stealing_deque::push(std::coroutine_handle<> co) {
+    const auto b   = _bottom.load(std::memory_order_relaxed);
+    const auto t   = _top.load(std::memory_order_acquire);
+    auto       buf = _buffer.load(std::memory_order_relaxed);
+    if (b - t > buf->capacity - 1) {
+        buf = _grow(buf, t, b);
+    }
+    buf->put(b, co.address());
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+std::coroutine_handle<> work_stealing_deque::pop() noexcept {
+    const auto b   = _bottom.load(std::memory_order_relaxed) - 1;
+    const auto buf = _buffer.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = _top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // Empty
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    void* item = buf->get(b);
+    if (t == b) {
+        // This is the last item. Race against thieves for it.
+        if (not _top.compare_exchange_strong(t,
+                                             t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+            item = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return std::coroutine_handle<>::from_address(item);
+}
+
+std::coroutine_handle<> work_stealing_deque::steal() noexcept {
+    auto t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto b = _bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    const auto buf  = _buffer.load(std::memory_order_acquire);
+    void*      item = buf->get(t);
+    if (not _top.compare_exchange_strong(t,
+                                         t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return std::coroutine_handle<>::from_address(item);
+}
+
+thread_pool_scheduler::thread_pool_scheduler(std::size_t n_threads) {
+    if (n_threads == 0) {
+        n_threads = std::thread::hardware_concurrency();
+    }
+    if (n_threads == 0) {
+        n_threads = 1;
+    }
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        _workers.push_back(std::make_unique<worker>());
+    }
+    for (std::size_t i = 0; i < n_threads; ++i) {
+        _workers[i]->thread = std::thread([this, i] { _run_worker(i); });
+    }
+}
+
+thread_pool_scheduler::~thread_pool_scheduler() {
+    _stop.store(true, std::memory_order_release);
+    _work_epoch.fetch_add(1, std::memory_order_release);
+    _work_epoch.notify_all();
+    for (auto& w : _workers) {
+        w->thread.join();
+    }
+}
+
+bool thread_pool_scheduler::running_in_this_thread() const noexcept {
+    return tl_current_worker.sched == this;
+}
+
+void thread_pool_scheduler::_notify_work() noexcept {
+    _work_epoch.fetch_add(1, std::memory_order_release);
+    _work_epoch.notify_one();
+}
+
+void thread_pool_scheduler::enqueue(std::coroutine_handle<> co) {
+    if (running_in_this_thread()) {
+        tl_current_worker.deque->push(co);
+    } else {
+        std::scoped_lock lk{_inject_mtx};
+        _injected.push_back(co);
+        _n_injected.fetch_add(1, std::memory_order_release);
+    }
+    _notify_work();
+}
+
+std::coroutine_handle<> thread_pool_scheduler::_pop_injected() noexcept {
+    if (_n_injected.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    std::scoped_lock lk{_inject_mtx};
+    if (_injected.empty()) {
+        return nullptr;
+    }
+    auto co = _injected.front();
+    _injected.pop_front();
+    _n_injected.fetch_sub(1, std::memory_order_relaxed);
+    return co;
+}
+
+std::coroutine_handle<> thread_pool_scheduler::_find_work(std::size_t index) noexcept {
+    if (auto co = _workers[index]->deque.pop()) {
+        return co;
+    }
+    if (auto co = _pop_injected()) {
+        return co;
+    }
+    // Try to steal from the other workers, starting at a random victim
+    thread_local std::uint32_t rng_state = static_cast<std::uint32_t>(index * 2654435761u + 1);
+    const auto                 n         = _workers.size();
+    const auto                 start     = next_random(rng_state) % n;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto victim = (start + i) % n;
+        if (victim == index) {
+            continue;
+        }
+        if (auto co = _workers[victim]->deque.steal()) {
+            return co;
+        }
+    }
+    return nullptr;
+}
+
+void thread_pool_scheduler::_run_worker(std::size_t index) {
+    tl_current_worker = {this, &_workers[index]->deque, index};
+    while (not _stop.load(std::memory_order_acquire)) {
+        // Read the epoch before looking for work, so that we will not sleep through any work
+        // that is posted after we look.
+        const auto epoch = _work_epoch.load(std::memory_order_acquire);
+        if (auto co = _find_work(index)) {
+            co.resume();
+            continue;
+        }
+        _work_epoch.wait(epoch, std::memory_order_acquire);
+    }
+    tl_current_worker = {};
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neo {
+
+namespace sched_detail {
+
+/**
+ * @brief A Chase-Lev work-stealing deque of coroutine handles.
+ *
+ * The owning thread pushes and pops at the bottom of the deque, while any other
+ * thread may steal from the top. The deque grows as needed. Old buffers are retained
+ * until the deque is destroyed, since a concurrent thief may still be reading from them.
+ *
+ * Implementation follows Lê, Pop, Cohen, and Zappa Nardelli: "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+class work_stealing_deque {
+    struct buffer {
+        std::int64_t                           capacity;
+        std::unique_ptr<std::atomic<void*>[]> items;
+
+        explicit buffer(std::int64_t cap)
+            : capacity(cap)
+            , items(new std::atomic<void*>[static_cast<std::size_t>(cap)]) {}
+
+        void* get(std::int64_t i) const noexcept {
+            return items[static_cast<std::size_t>(i & (capacity - 1))].load(
+                std::memory_order_relaxed);
+        }
+        void put(std::int64_t i, void* p) noexcept {
+            items[static_cast<std::size_t>(i & (capacity - 1))].store(p,
+                                                                      std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<std::int64_t> _top{0};
+    alignas(64) std::atomic<std::int64_t> _bottom{0};
+    std::atomic<buffer*>                 _buffer;
+    std::vector<std::unique_ptr<buffer>> _buffers;
+
+    buffer* _grow(buffer* old, std::int64_t top, std::int64_t bottom);
+
+public:
+    explicit work_stealing_deque(std::int64_t initial_capacity = 256);
+
+    /// Push a new item at the bottom. Only call from the owning thread.
+    void push(std::coroutine_handle<> co);
+    /// Pop an item from the bottom. Only call from the owning thread. Returns null if empty.
+    std::coroutine_handle<> pop() noexcept;
+    /// Steal an item from the top. May be called from any thread. Returns null if empty or if
+    /// the steal lost a race with another thread.
+    std::coroutine_handle<> steal() noexcept;
+};
+
+}  // namespace sched_detail
+
+/**
+ * @brief A scheduler that resumes coroutines on a fixed pool of worker threads.
+ *
+ * Each worker has its own work-stealing deque. Coroutines scheduled from a worker
+ * thread are pushed onto that worker's deque, and coroutines scheduled from other
+ * threads are placed in a shared injection queue. Idle workers steal from each other.
+ *
+ * Use `co_await sched.schedule()` to move the current coroutine onto the pool.
+ *
+ * All scheduled coroutines must have completed or be suspended elsewhere before the
+ * scheduler is destroyed. The destructor stops and joins all worker threads.
+ */
+class thread_pool_scheduler {
+    struct worker {
+        sched_detail::work_stealing_deque deque;
+        std::thread                       thread;
+    };
+
+    std::vector<std::unique_ptr<worker>> _workers;
+
+    std::mutex                          _inject_mtx;
+    std::deque<std::coroutine_handle<>> _injected;
+    std::atomic<std::size_t>            _n_injected{0};
+
+    // Incremented whenever new work is made available. Sleeping workers wait on this value.
+    std::atomic<std::uint64_t> _work_epoch{0};
+    std::atomic<bool>          _stop{false};
+
+    void _run_worker(std::size_t index);
+    std::coroutine_handle<> _find_work(std::size_t index) noexcept;
+    std::coroutine_handle<> _pop_injected() noexcept;
+    void                    _notify_work() noexcept;
+
+public:
+    /**
+     * @brief Create a new scheduler with the given number of worker threads.
+     *
+     * @param n_threads The number of threads to spawn. If zero, uses the number of hardware
+     * threads.
+     */
+    explicit thread_pool_scheduler(std::size_t n_threads = 0);
+    ~thread_pool_scheduler();
+
+    thread_pool_scheduler(const thread_pool_scheduler&)            = delete;
+    thread_pool_scheduler& operator=(const thread_pool_scheduler&) = delete;
+
+    /// The number of worker threads in the pool
+    std::size_t size() const noexcept { return _workers.size(); }
+
+    /**
+     * @brief Schedule the given coroutine to be resumed on one of the worker threads.
+     */
+    void enqueue(std::coroutine_handle<> co);
+
+    /// Determine whether the calling thread is a worker thread of this scheduler
+    bool running_in_this_thread() const noexcept;
+
+    /// The awaiter returned by `schedule()`
+    struct schedule_awaiter {
+        thread_pool_scheduler& sched;
+
+        constexpr bool await_ready() const noexcept { return false; }
+        void           await_suspend(std::coroutine_handle<> co) const { sched.enqueue(co); }
+        constexpr void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Return an awaitable that, when awaited, suspends the current coroutine and
+     * resumes it on one of the pool's worker threads.
+     */
+    [[nodiscard]] schedule_awaiter schedule() noexcept { return schedule_awaiter{*this}; }
+};
+
+}  // namespace neo
@@ -0,0 +1,59 @@
+#include "./thread_pool_scheduler.hpp"
+
+#include "./sync_wait.hpp"
+#include "./task.hpp"
+#include "./when_all.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+
+namespace {
+
+neo::task<std::thread::id> get_thread_id(neo::thread_pool_scheduler& sched) {
+    co_await sched.schedule();
+    co_return std::this_thread::get_id();
+}
+
+neo::task<long> fib(neo::thread_pool_scheduler& sched, int n) {
+    co_await sched.schedule();
+    if (n < 2) {
+        co_return n;
+    }
+    auto [a, b] = co_await neo::when_all(fib(sched, n - 1), fib(sched, n - 2));
+    co_return a + b;
+}
+
+}  // namespace
+
+TEST_CASE("Move a coroutine onto the thread pool") {
+    neo::thread_pool_scheduler sched{2};
+    CHECK(sched.size() == 2);
+    CHECK_FALSE(sched.running_in_this_thread());
+    auto id = neo::sync_wait(get_thread_id(sched));
+    CHECK(id != std::this_thread::get_id());
+}
+
+TEST_CASE("Spread work across workers") {
+    neo::thread_pool_scheduler sched{4};
+    CHECK(neo::sync_wait(fib(sched, 20)) == 6765);
+}
+
+TEST_CASE("Work-stealing deque") {
+    neo::sched_detail::work_stealing_deque dq{2};
+    // Use fake handles: We never resume them
+    int  objs[10];
+    auto handle = [&](int i) { return std::coroutine_handle<>::from_address(&objs[i]); };
+    for (int i = 0; i < 10; ++i) {
+        dq.push(handle(i));
+    }
+    // Thieves take from the top, the owner pops from the bottom
+    CHECK(dq.steal() == handle(0));
+    CHECK(dq.pop() == handle(9));
+    CHECK(dq.steal() == handle(1));
+    for (int i = 8; i >= 2; --i) {
+        CHECK(dq.pop() == handle(i));
+    }
+    CHECK_FALSE(dq.pop());
+    CHECK_FALSE(dq.steal());
+}
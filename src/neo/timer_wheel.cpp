@@ -0,0 +1,157 @@
+#include "./timer_wheel.hpp"
+
+#include "./assert.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+using namespace neo;
+
+timer_wheel::timer_wheel(duration tick, time_point start)
+    : _tick(tick)
+    , _start(start)
+    , _now(start) {
+    neo_assert(expects, tick > duration::zero(), "The tick of a timer_wheel must be positive");
+}
+
+void timer_wheel::schedule(entry& e, time_point deadline) noexcept {
+    neo_assert(expects, not e.scheduled(), "The timer is already scheduled");
+    // Round up, so that the timer never fires early
+    std::uint64_t tick = 0;
+    if (deadline > _start) {
+        tick = static_cast<std::uint64_t>((deadline - _start + _tick - duration(1)) / _tick);
+    }
+    // Expired timers fire on the next tick, never in the middle of firing the current one
+    e._expiry = std::max(tick, _now_tick + 1);
+    _insert(e);
+    ++_size;
+}
+
+void timer_wheel::cancel(entry& e) noexcept {
+    if (e.scheduled()) {
+        _unlink(e);
+        --_size;
+    }
+}
+
+timer_wheel::entry*& timer_wheel::_head_of(const entry& e) noexcept {
+    if (e._level == n_levels) {
+        return _overflow;
+    }
+    return _levels[e._level].slots[e._slot];
+}
+
+void timer_wheel::_insert(entry& e) noexcept {
+    // The level is determined by the highest bit in which the expiry differs from the
+    // current tick. Every timer on a level above zero moves down a level (a "cascade") when
+    // the current tick reaches the start of its slot.
+    const auto diff = e._expiry ^ _now_tick;
+    const int  lvl  = diff == 0 ? 0 : (std::bit_width(diff) - 1) / level_bits;
+    if (lvl >= n_levels) {
+        e._level = n_levels;
+        e._slot  = 0;
+    } else {
+        const auto slot = (e._expiry >> (lvl * level_bits)) & (n_slots - 1);
+        e._level        = static_cast<std::int8_t>(lvl);
+        e._slot         = static_cast<std::uint16_t>(slot);
+        _levels[lvl].occupied[slot / 64] |= std::uint64_t(1) << (slot % 64);
+    }
+    auto& head = _head_of(e);
+    e._prev    = nullptr;
+    e._next    = head;
+    if (e._next) {
+        e._next->_prev = &e;
+    }
+    head = &e;
+}
+
+void timer_wheel::_unlink(entry& e) noexcept {
+    if (e._prev) {
+        e._prev->_next = e._next;
+    } else {
+        _head_of(e) = e._next;
+        if (e._next == nullptr and e._level != n_levels) {
+            // The slot is now empty
+            _levels[e._level].occupied[e._slot / 64] &= ~(std::uint64_t(1) << (e._slot % 64));
+        }
+    }
+    if (e._next) {
+        e._next->_prev = e._prev;
+    }
+    e._level = -1;
+    e._prev = e._next = nullptr;
+}
+
+void timer_wheel::_cascade(entry*& head) noexcept {
+    auto e = head;
+    while (e) {
+        auto& cur = *e;
+        e         = cur._next;
+        _unlink(cur);
+        _insert(cur);
+    }
+}
+
+std::uint64_t timer_wheel::_next_event_tick() const noexcept {
+    // Every timer on a level is in a slot after the current one, and the slots of each level
+    // come before those of the level above, so the first occupied slot on the lowest occupied
+    // level holds the next event.
+    for (int lvl = 0; lvl < n_levels; ++lvl) {
+        auto& l = _levels[lvl];
+        for (std::size_t w = 0; w < std::size(l.occupied); ++w) {
+            if (const auto bits = l.occupied[w]) {
+                const auto slot  = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                const int  shift = (lvl + 1) * level_bits;
+                return (_now_tick >> shift << shift) | (slot << (lvl * level_bits));
+            }
+        }
+    }
+    constexpr int top_shift = n_levels * level_bits;
+    return ((_now_tick >> top_shift) + 1) << top_shift;
+}
+
+optional<timer_wheel::time_point> timer_wheel::next_expiry() const noexcept {
+    if (_size == 0) {
+        return nullopt;
+    }
+    return _start + _tick * static_cast<duration::rep>(_next_event_tick());
+}
+
+std::size_t timer_wheel::advance(time_point now) {
+    if (now <= _now) {
+        return 0;
+    }
+    _now                = now;
+    const auto  target  = static_cast<std::uint64_t>((now - _start) / _tick);
+    std::size_t n_fired = 0;
+    while (_size != 0) {
+        const auto t = _next_event_tick();
+        if (t > target) {
+            break;
+        }
+        _now_tick = t;
+        // Move down the timers whose slots begin at this tick, from the top level down
+        constexpr int top_shift = n_levels * level_bits;
+        if ((t & ((std::uint64_t(1) << top_shift) - 1)) == 0) {
+            _cascade(_overflow);
+        }
+        for (int lvl = n_levels - 1; lvl > 0; --lvl) {
+            const int shift = lvl * level_bits;
+            if ((t & ((std::uint64_t(1) << shift) - 1)) == 0) {
+                _cascade(_levels[lvl].slots[(t >> shift) & (n_slots - 1)]);
+            }
+        }
+        // Fire the timers that expire at this tick. They may schedule or cancel other timers.
+        auto& slot = _levels[0].slots[t & (n_slots - 1)];
+        while (slot) {
+            auto& e = *slot;
+            _unlink(e);
+            --_size;
+            ++n_fired;
+            e.fire(e);
+        }
+    }
+    _now_tick = std::max(_now_tick, target);
+    return n_fired;
+}
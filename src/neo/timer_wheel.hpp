@@ -0,0 +1,380 @@
+#pragma once
+
+#include "./await.hpp"
+#include "./frame_alloc.hpp"
+#include "./fwd.hpp"
+#include "./optional.hpp"
+#include "./type_traits.hpp"
+#include "./unit.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+
+namespace neo {
+
+namespace timer_wheel_detail {
+
+// Implements the return value aspect of the coroutine used by `with_deadline()`
+template <typename T>
+struct race_return {
+    optional<T> value;
+
+    template <typename U>
+    void return_value(U&& u) {
+        value.emplace(NEO_FWD(u));
+    }
+};
+
+template <void_type T>
+struct race_return<T> {
+    optional<unit> value;
+
+    void return_void() noexcept { value.emplace(); }
+};
+
+}  // namespace timer_wheel_detail
+
+/**
+ * @brief A hashed hierarchical timing wheel that resumes coroutines at given points in time.
+ *
+ * Scheduling and cancelling a timer are constant-time operations, which keeps the wheel
+ * cheap with very many pending timers, such as idle timeouts for every open connection.
+ *
+ * Time is quantized into ticks. A timer never fires before its deadline, but may fire up to
+ * one tick after it. The wheel does not watch a clock by itself: Time only moves forward
+ * through calls to `advance()`, which fires the timers that have expired. This makes it
+ * deterministic to test. To drive the wheel alongside an event loop, wait for at most
+ * `next_expiry()`, then call `advance(clock::now())`:
+ *
+ * ```
+ * while (running) {
+ *     auto next = wheel.next_expiry();
+ *     reactor.run_one(next ? milliseconds_until(*next) : -1);
+ *     wheel.advance(neo::timer_wheel::clock::now());
+ * }
+ * ```
+ *
+ * The wheel is not thread-safe. Timers fire on the thread that calls `advance()`.
+ */
+class timer_wheel {
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+    using duration   = clock::duration;
+
+    /**
+     * @brief An intrusive timer that can be scheduled on a wheel.
+     *
+     * The `fire` function pointer is called when the timer expires. The entry must not be
+     * moved or destroyed while it is scheduled.
+     */
+    struct entry {
+        entry() = default;
+        explicit entry(void (*fn)(entry&) noexcept) noexcept
+            : fire(fn) {}
+
+        /// Called when the timer expires. The entry is no longer scheduled during the call.
+        void (*fire)(entry& self) noexcept = nullptr;
+
+        /// Whether the entry is currently scheduled on a wheel
+        [[nodiscard]] bool scheduled() const noexcept { return _level >= 0; }
+
+    private:
+        friend timer_wheel;
+
+        entry*        _prev   = nullptr;
+        entry*        _next   = nullptr;
+        std::uint64_t _expiry = 0;
+        // The slot holding the entry. The overflow list is the level past the top.
+        std::uint16_t _slot  = 0;
+        std::int8_t   _level = -1;
+    };
+
+private:
+    // Each level of the wheel has 2^level_bits slots
+    static constexpr int         level_bits = 8;
+    static constexpr std::size_t n_slots    = std::size_t(1) << level_bits;
+    static constexpr int         n_levels   = 4;
+
+    struct level {
+        entry*        slots[n_slots] = {};
+        std::uint64_t occupied[n_slots / 64] = {};
+    };
+
+    duration   _tick;
+    time_point _start;
+    time_point _now;
+    // The tick up to which all timers have been fired
+    std::uint64_t _now_tick = 0;
+    std::size_t   _size     = 0;
+
+    level _levels[n_levels];
+    // Timers too far in the future for the top level
+    entry* _overflow = nullptr;
+
+    entry*&       _head_of(const entry& e) noexcept;
+    void          _insert(entry& e) noexcept;
+    void          _unlink(entry& e) noexcept;
+    void          _cascade(entry*& head) noexcept;
+    std::uint64_t _next_event_tick() const noexcept;
+
+    template <typename T, typename A>
+    class race;
+
+    template <typename T, typename A>
+    static race<T, A> _make_race(A a);
+
+public:
+    /**
+     * @brief Create a new timer wheel.
+     *
+     * @param tick The resolution of the wheel.
+     * @param start The initial time of the wheel.
+     */
+    explicit timer_wheel(duration   tick  = std::chrono::milliseconds(1),
+                         time_point start = clock::now());
+
+    timer_wheel(const timer_wheel&)            = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /// The time given to the most recent call to `advance()`, or the start time
+    [[nodiscard]] time_point now() const noexcept { return _now; }
+
+    /// The number of scheduled timers
+    [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+    /**
+     * @brief Schedule the entry to fire once `advance()` reaches the given time.
+     *
+     * If the deadline has already passed, the entry fires on the next call to `advance()`.
+     *
+     * @pre The entry is not scheduled.
+     */
+    void schedule(entry& e, time_point deadline) noexcept;
+
+    /// Unschedule the entry, if it is scheduled
+    void cancel(entry& e) noexcept;
+
+    /**
+     * @brief Move the wheel forward to the given time, firing each timer that has expired.
+     *
+     * Timers may schedule further timers as they fire. Those are fired as well if they
+     * have also expired.
+     *
+     * @return The number of timers that fired.
+     */
+    std::size_t advance(time_point now);
+
+    /**
+     * @brief The time at which the wheel next has work to do, or `nullopt` if no timers are
+     * scheduled.
+     *
+     * This may be earlier than the next expiry, when timers must move down to a finer level
+     * of the wheel. It is never later.
+     */
+    [[nodiscard]] optional<time_point> next_expiry() const noexcept;
+
+    /// Awaitable returned by `sleep_until()` and `sleep_for()`
+    class [[nodiscard]] sleep_awaiter : entry {
+        timer_wheel&            _wheel;
+        time_point              _deadline;
+        std::coroutine_handle<> _co;
+
+        static void _resume(entry& self) noexcept {
+            static_cast<sleep_awaiter&>(self)._co.resume();
+        }
+
+    public:
+        sleep_awaiter(timer_wheel& w, time_point deadline) noexcept
+            : entry{&_resume}
+            , _wheel(w)
+            , _deadline(deadline) {}
+
+        // Cancel the timer if the awaiting coroutine is destroyed while suspended
+        ~sleep_awaiter() { _wheel.cancel(*this); }
+
+        bool await_ready() const noexcept { return _deadline <= _wheel.now(); }
+        void await_suspend(std::coroutine_handle<> co) noexcept {
+            _co = co;
+            _wheel.schedule(*this, _deadline);
+        }
+        constexpr void await_resume() const noexcept {}
+    };
+
+    /// Suspend the awaiting coroutine until `advance()` reaches the given time
+    sleep_awaiter sleep_until(time_point t) noexcept { return sleep_awaiter{*this, t}; }
+
+    /// Suspend the awaiting coroutine for the given duration, measured from `now()`
+    sleep_awaiter sleep_for(duration d) noexcept { return sleep_until(_now + d); }
+
+    /// Awaitable returned by `with_deadline()`
+    template <typename T, typename A>
+    class deadline_awaiter;
+
+    /**
+     * @brief Await an awaitable with a deadline.
+     *
+     * The result of the `co_await` is an `optional` of the result of the awaitable (`unit`
+     * for `void`), which is `nullopt` if the deadline passed before the awaitable completed.
+     * Exceptions from the awaitable are rethrown, unless the deadline has already passed.
+     *
+     * On timeout, the awaiting coroutine is resumed right away, but the awaitable cannot
+     * be interrupted in general: It is moved into a separate coroutine frame, which
+     * continues waiting for it, and discards its result. The caller should arrange for the
+     * awaited operation to finish (e.g. with `epoll_reactor::cancel()`) if it refers to
+     * objects that are about to be destroyed.
+     *
+     * The awaitable must complete on the thread that drives the wheel.
+     */
+    template <awaitable A>
+    deadline_awaiter<await_result_t<A>, remove_cvref_t<A>> with_deadline(A&& a, time_point t) {
+        return {*this, t, _make_race<await_result_t<A>>(NEO_FWD(a))};
+    }
+};
+
+/**
+ * @brief The coroutine that awaits the operation given to `with_deadline()`. It is shared
+ * between the awaiter and the coroutine itself, and is destroyed by whichever finishes last.
+ */
+template <typename T, typename A>
+class timer_wheel::race {
+public:
+    struct promise_type : timer_wheel_detail::race_return<T>,
+                          frame_alloc_promise_base_for<"neo::timer_wheel::with_deadline"> {
+        // The timer for the deadline, which refers back to the promise
+        struct deadline_timer : entry {
+            promise_type* self;
+        };
+
+        std::exception_ptr      exc;
+        std::coroutine_handle<> continuation;
+        timer_wheel*            wheel = nullptr;
+        deadline_timer          timer{{}, this};
+        // The awaiter, and (once started) the coroutine itself
+        int  refs      = 1;
+        bool timed_out = false;
+        // Set once the awaiting coroutine has moved on or has been destroyed
+        bool detached = false;
+
+        void release() noexcept {
+            if (--refs == 0) {
+                std::coroutine_handle<promise_type>::from_promise(*this).destroy();
+            }
+        }
+
+        race get_return_object() noexcept {
+            return race{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        auto final_suspend() noexcept {
+            struct awaiter {
+                constexpr bool          await_ready() const noexcept { return false; }
+                std::coroutine_handle<>
+                await_suspend(std::coroutine_handle<promise_type> co) noexcept {
+                    auto& self = co.promise();
+                    if (self.detached) {
+                        // The awaiter has already moved on
+                        self.release();
+                        return std::noop_coroutine();
+                    }
+                    self.wheel->cancel(self.timer);
+                    auto next = self.continuation;
+                    self.release();
+                    return next;
+                }
+                constexpr void await_resume() const noexcept {}
+            };
+            return awaiter{};
+        }
+
+        void unhandled_exception() noexcept { exc = std::current_exception(); }
+    };
+
+    explicit race(std::coroutine_handle<promise_type> co) noexcept
+        : _co(co) {}
+
+    race(race&& o) noexcept
+        : _co(std::exchange(o._co, nullptr)) {}
+
+    ~race() {
+        if (_co) {
+            _co.promise().release();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle() const noexcept { return _co; }
+
+private:
+    std::coroutine_handle<promise_type> _co;
+};
+
+template <typename T, typename A>
+timer_wheel::race<T, A> timer_wheel::_make_race(A a) {
+    if constexpr (void_type<T>) {
+        co_await NEO_MOVE(a);
+    } else {
+        co_return co_await NEO_MOVE(a);
+    }
+}
+
+template <typename T, typename A>
+class timer_wheel::deadline_awaiter {
+    using promise_type = typename race<T, A>::promise_type;
+
+    timer_wheel& _wheel;
+    time_point   _deadline;
+    race<T, A>   _race;
+
+    static void _timeout(entry& e) noexcept {
+        auto& pr = *static_cast<typename promise_type::deadline_timer&>(e).self;
+        pr.timed_out = true;
+        pr.detached  = true;
+        pr.continuation.resume();
+    }
+
+public:
+    deadline_awaiter(timer_wheel& w, time_point deadline, race<T, A>&& r) noexcept
+        : _wheel(w)
+        , _deadline(deadline)
+        , _race(NEO_MOVE(r)) {}
+
+    // If the awaiting coroutine is destroyed while suspended, cancel the deadline, and let the
+    // race finish without resuming it
+    ~deadline_awaiter() {
+        auto& pr = _race.handle().promise();
+        _wheel.cancel(pr.timer);
+        pr.detached = true;
+    }
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> co) noexcept {
+        auto& pr        = _race.handle().promise();
+        pr.continuation = co;
+        pr.wheel        = &_wheel;
+        pr.timer.fire   = &_timeout;
+        ++pr.refs;
+        _wheel.schedule(pr.timer, _deadline);
+        // Symmetric transfer to the race. If the awaitable completes right away, the race
+        // cancels the timer and resumes us immediately.
+        return _race.handle();
+    }
+
+    optional<nonvoid_t<T>> await_resume() {
+        auto& pr = _race.handle().promise();
+        if (pr.timed_out) {
+            return nullopt;
+        }
+        if (pr.exc) {
+            std::rethrow_exception(pr.exc);
+        }
+        return NEO_MOVE(pr.value);
+    }
+};
+
+}  // namespace neo
@@ -0,0 +1,290 @@
+#include "./timer_wheel.hpp"
+
+#include "./task.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+using clock_type = neo::timer_wheel::clock;
+
+namespace {
+
+/// A coroutine that starts immediately, for driving tasks from a test
+struct eager {
+    struct promise_type {
+        eager              get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void               return_void() const noexcept {}
+        [[noreturn]] void  unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+eager start(neo::task<>& t) { co_await t; }
+
+/// A coroutine that starts immediately, and is destroyed by its owner
+struct owned {
+    struct promise_type {
+        owned get_return_object() noexcept {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_never  initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void                return_void() const noexcept {}
+        [[noreturn]] void   unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> co;
+};
+
+/// An entry that records the order in which timers fire
+struct recording_entry : neo::timer_wheel::entry {
+    std::vector<int>* log;
+    int               id;
+
+    recording_entry(std::vector<int>& l, int i)
+        : entry(&record)
+        , log(&l)
+        , id(i) {}
+
+    static void record(entry& e) noexcept {
+        auto& self = static_cast<recording_entry&>(e);
+        self.log->push_back(self.id);
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Fire timers in order") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+    std::vector<int> fired;
+    recording_entry  a{fired, 1}, b{fired, 2}, c{fired, 3}, d{fired, 4};
+    wheel.schedule(c, t0 + 300ms);
+    wheel.schedule(a, t0 + 5ms);
+    wheel.schedule(d, t0 + 90'000ms);
+    wheel.schedule(b, t0 + 40ms);
+    CHECK(wheel.size() == 4);
+    CHECK(wheel.next_expiry() == t0 + 5ms);
+
+    CHECK(wheel.advance(t0 + 4ms) == 0);
+    CHECK(wheel.advance(t0 + 5ms) == 1);
+    CHECK(fired == std::vector<int>{1});
+    CHECK(wheel.advance(t0 + 299ms) == 1);
+    CHECK(fired == std::vector<int>{1, 2});
+    // Timers are never late by more than a tick, even after a cascade
+    CHECK(wheel.advance(t0 + 300ms) == 1);
+    CHECK(wheel.advance(t0 + 89'999ms) == 0);
+    CHECK(d.scheduled());
+    CHECK(wheel.advance(t0 + 90'000ms) == 1);
+    CHECK(fired == std::vector<int>{1, 2, 3, 4});
+    CHECK(wheel.size() == 0);
+    CHECK_FALSE(wheel.next_expiry());
+}
+
+TEST_CASE("Cancel timers") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+    std::vector<int> fired;
+    recording_entry  a{fired, 1}, b{fired, 2}, c{fired, 3};
+    wheel.schedule(a, t0 + 10ms);
+    wheel.schedule(b, t0 + 10ms);
+    wheel.schedule(c, t0 + 10ms);
+    wheel.cancel(b);
+    CHECK_FALSE(b.scheduled());
+    // Cancelling twice is fine
+    wheel.cancel(b);
+    CHECK(wheel.size() == 2);
+    wheel.advance(t0 + 1s);
+    std::sort(fired.begin(), fired.end());
+    CHECK(fired == std::vector<int>{1, 3});
+}
+
+TEST_CASE("Timers in the far future") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+    std::vector<int> fired;
+    // Beyond the range of the top level of the wheel (2^32 ticks)
+    recording_entry far{fired, 1};
+    const auto      far_deadline = t0 + std::chrono::hours(24 * 100);
+    wheel.schedule(far, far_deadline);
+    CHECK(wheel.advance(far_deadline - 1ms) == 0);
+    CHECK(wheel.advance(far_deadline) == 1);
+    CHECK(fired == std::vector<int>{1});
+}
+
+TEST_CASE("Many random timers fire on time") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+
+    struct checked_entry : neo::timer_wheel::entry {
+        neo::timer_wheel*       wheel = nullptr;
+        clock_type::time_point  deadline;
+        clock_type::time_point* prev_now = nullptr;
+        int*                    n_fired  = nullptr;
+
+        // Each timer must fire in the first call to advance() that reaches its deadline
+        static void check(entry& e) noexcept {
+            auto& self = static_cast<checked_entry&>(e);
+            CHECK(self.wheel->now() >= self.deadline);
+            CHECK(*self.prev_now < self.deadline);
+            ++*self.n_fired;
+        }
+    };
+
+    std::mt19937                    rng{1729};
+    std::uniform_int_distribution<> dist{1, 2'000'000};
+    std::vector<checked_entry>      entries(20'000);
+    int                             n_fired = 0;
+    auto                            prev    = t0;
+    for (auto& e : entries) {
+        e.fire     = &checked_entry::check;
+        e.wheel    = &wheel;
+        e.deadline = t0 + std::chrono::milliseconds(dist(rng));
+        e.prev_now = &prev;
+        e.n_fired  = &n_fired;
+        wheel.schedule(e, e.deadline);
+    }
+    // Cancel every tenth timer
+    for (std::size_t i = 0; i < entries.size(); i += 10) {
+        wheel.cancel(entries[i]);
+    }
+    // Step through time unevenly
+    while (wheel.size() != 0) {
+        auto now = prev + std::chrono::milliseconds(dist(rng) % 977);
+        wheel.advance(now);
+        prev = now;
+    }
+    CHECK(n_fired == 18'000);
+}
+
+TEST_CASE("Sleep in a coroutine") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+    std::vector<std::string> log;
+
+    auto sleeper = [&](std::string name, clock_type::duration d) -> neo::task<> {
+        co_await wheel.sleep_for(d);
+        log.push_back(name);
+        co_await wheel.sleep_for(d);
+        log.push_back(name);
+    };
+    auto a = sleeper("a", 10ms);
+    auto b = sleeper("b", 15ms);
+    start(a);
+    start(b);
+    CHECK(wheel.size() == 2);
+    wheel.advance(t0 + 10ms);
+    CHECK(log == std::vector<std::string>{"a"});
+    wheel.advance(t0 + 16ms);
+    CHECK(log == std::vector<std::string>{"a", "b"});
+    wheel.advance(t0 + 1s);
+    CHECK(log == std::vector<std::string>{"a", "b", "a", "b"});
+    CHECK(wheel.size() == 0);
+}
+
+TEST_CASE("Await with a deadline") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+
+    auto slow_value = [&](clock_type::duration d, int v) -> neo::task<int> {
+        co_await wheel.sleep_for(d);
+        co_return v;
+    };
+    neo::optional<int> fast_result;
+    neo::optional<int> slow_result{-1};
+    auto               waiter = [&]() -> neo::task<> {
+        fast_result = co_await wheel.with_deadline(slow_value(5ms, 42), t0 + 20ms);
+        slow_result = co_await wheel.with_deadline(slow_value(50ms, 7), t0 + 20ms);
+    };
+    auto t = waiter();
+    start(t);
+    wheel.advance(t0 + 5ms);
+    CHECK(fast_result == 42);
+    // The deadline timer was cancelled, and the slow task and its deadline are pending
+    CHECK(wheel.size() == 2);
+    wheel.advance(t0 + 20ms);
+    CHECK_FALSE(slow_result.has_value());
+    // The abandoned task runs to completion on its own
+    CHECK(wheel.size() == 1);
+    wheel.advance(t0 + 1s);
+    CHECK(wheel.size() == 0);
+}
+
+TEST_CASE("Exceptions through a deadline") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+
+    auto fails = [&]() -> neo::task<> {
+        co_await wheel.sleep_for(1ms);
+        throw std::runtime_error("oops");
+    };
+    bool caught = false;
+    auto waiter = [&]() -> neo::task<> {
+        try {
+            co_await wheel.with_deadline(fails(), t0 + 10ms);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+    };
+    auto t = waiter();
+    start(t);
+    wheel.advance(t0 + 1s);
+    CHECK(caught);
+}
+
+TEST_CASE("Destroy a coroutine that is awaiting with a deadline") {
+    const auto       t0 = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+
+    bool resumed = false;
+    auto waiter  = [&]() -> owned {
+        co_await wheel.with_deadline(wheel.sleep_until(t0 + 50ms), t0 + 5ms);
+        resumed = true;
+    };
+    auto o = waiter();
+    CHECK(wheel.size() == 2);
+    o.co.destroy();
+    // The deadline was cancelled, and the sleep finishes without resuming the waiter
+    CHECK(wheel.size() == 1);
+    wheel.advance(t0 + 1s);
+    CHECK_FALSE(resumed);
+    CHECK(wheel.size() == 0);
+}
+
+TEST_CASE("Timer wheel throughput", "[.][benchmark]") {
+    // Schedule many timers, cancel half of them, and expire the rest one tick at a time
+    const int        n_timers = 500'000;
+    const auto       t0       = clock_type::time_point{};
+    neo::timer_wheel wheel{1ms, t0};
+    std::vector<int> fired;
+    fired.reserve(n_timers);
+    std::vector<recording_entry> entries;
+    entries.reserve(n_timers);
+    std::mt19937                    rng{42};
+    std::uniform_int_distribution<> dist{1, 60'000};
+
+    auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < n_timers; ++i) {
+        auto& e = entries.emplace_back(fired, i);
+        wheel.schedule(e, t0 + std::chrono::milliseconds(dist(rng)));
+    }
+    for (std::size_t i = 0; i < entries.size(); i += 2) {
+        wheel.cancel(entries[i]);
+    }
+    for (auto now = t0; wheel.size() != 0; now += 1ms) {
+        wheel.advance(now);
+    }
+    auto dur = std::chrono::steady_clock::now() - start_time;
+    CHECK(fired.size() == n_timers / 2);
+    std::printf("%6.2f ns per timer\n",
+                std::chrono::duration<double, std::nano>(dur).count() / n_timers);
+}
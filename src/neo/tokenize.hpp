@@ -12,7 +12,12 @@
 #include "./text_range.hpp"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
 namespace neo {
 
@@ -81,28 +86,44 @@ struct is_whitespace_fn {
 
 /**
  * @brief A string searcher that finds the next newline sequence in `view` (LF or CRLF)
+ *
+ * Contiguous ranges of byte-sized characters are searched with `std::memchr`, which is
+ * vectorized by the C library.
  */
 struct find_newline_fn {
     template <text_range T>
     constexpr substring_t<T> operator()(T&& view) const noexcept(ranges::nothrow_range<T>) {
-        // A CRLF constant range to help compare against
-        std::ranges::range_value_t<T> crlf_arr[3] = {'\r', '\n', 0};
-        const auto                    crlf        = substring(crlf_arr);
-        std::ranges::range_value_t<T> lf_arr[2]   = {'\n', 0};
-        auto                          lf          = substring(lf_arr);
-        // Advance as iterators
-        auto sub = substring(view);
-        while (not sub.empty() and not neo::starts_with(sub, lf)
-               and not neo::starts_with(sub, crlf)) {
-            sub = substring(sub, 1);
+        auto       sub   = substring(view);
+        const auto first = std::ranges::begin(sub);
+        const auto stop  = std::ranges::end(sub);
+        using char_type  = std::ranges::range_value_t<T>;
+        if constexpr (std::ranges::contiguous_range<decltype(sub)>
+                      and std::ranges::sized_range<decltype(sub)>
+                      and std::is_integral_v<char_type> and sizeof(char_type) == 1) {
+            if (not std::is_constant_evaluated()) {
+                const auto data = std::to_address(first);
+                const auto size = std::ranges::size(sub);
+                const auto nl   = static_cast<const char_type*>(std::memchr(data, '\n', size));
+                if (nl == nullptr) {
+                    return substring(sub, stop, stop);
+                }
+                const auto nl_it = first + (nl - data);
+                if (nl != data and nl[-1] == '\r') {
+                    return substring(sub, nl_it - 1, nl_it + 1);
+                }
+                return substring(sub, nl_it, nl_it + 1);
+            }
         }
-        if (neo::starts_with(sub, crlf)) {
-            return substring(sub, 0, 2);
-        } else if (neo::starts_with(sub, lf)) {
-            return substring(sub, 0, 1);
+        // Find the LF, and remember whether a CR came right before it
+        auto prev = first;
+        for (auto it = first; it != stop; prev = it, ++it) {
+            if (*it == '\n') {
+                auto nl_begin = (it != first and *prev == '\r') ? prev : it;
+                return substring(sub, nl_begin, std::ranges::next(it));
+            }
         }
-        // "v" is empty:
-        return sub;
+        // "v" has no newline:
+        return substring(sub, stop, stop);
     }
 };
 
@@ -263,6 +284,36 @@ inline constexpr struct iter_lines_fn {
     }
 } iter_lines;
 
+/**
+ * @brief Find the offset of the beginning of every line of a text, in a single pass.
+ *
+ * The offsets are those of the lines that `iter_lines()` would produce: The first line begins
+ * at zero, and another line begins after each LF or CRLF. Empty text has no lines. Line `i`
+ * ends at the newline sequence that precedes offset `i + 1`, or at the end of the text.
+ */
+inline constexpr struct line_offsets_fn {
+    template <viewable_text_range Text>
+    constexpr std::vector<std::size_t> operator()(Text&& text) const {
+        std::vector<std::size_t> ret;
+        auto                     rest = substring(neo::view_text(text));
+        if (std::ranges::empty(rest)) {
+            return ret;
+        }
+        ret.push_back(0);
+        std::size_t offset = 0;
+        while (true) {
+            auto nl = find_newline_fn{}(rest);
+            if (std::ranges::empty(nl)) {
+                return ret;
+            }
+            offset += static_cast<std::size_t>(
+                std::ranges::distance(std::ranges::begin(rest), std::ranges::end(nl)));
+            ret.push_back(offset);
+            rest = substring(rest, std::ranges::end(nl), std::ranges::end(rest));
+        }
+    }
+} line_offsets;
+
 }  // namespace neo
 
 namespace std::ranges {
@@ -5,6 +5,12 @@
 #include "./tl.hpp"
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <string_view>
+#include <vector>
+
 constexpr inline auto eq = neo::text_range_equal_to{};
 
 TEST_CASE("Tokenize a simple string") {
@@ -57,3 +63,71 @@ TEST_CASE("Iterate some lines") {
         CHECK(eq(lines[4], ""));
     }
 }
+
+TEST_CASE("Iterate lines with CRLF") {
+    std::string s     = "foo\r\nbar\rbaz\n\r\n\r";
+    auto        lines = neo::to_vector(neo::iter_lines(s));
+    CHECKED_IF(lines.size() == 4) {
+        CHECK(eq(lines[0], "foo"));
+        CHECK(eq(lines[1], "bar\rbaz"));
+        CHECK(eq(lines[2], ""));
+        CHECK(eq(lines[3], "\r"));
+    }
+
+    // The same, but through the generic path
+    std::list<char> l(s.begin(), s.end());
+    auto            list_lines = neo::to_vector(neo::iter_lines(l));
+    CHECK(list_lines.size() == 4);
+    CHECK(std::ranges::equal(list_lines[1], std::string_view("bar\rbaz")));
+}
+
+// The generic path is used in constant evaluation
+static_assert(eq(neo::find_newline_fn{}(std::string_view("ab\r\ncd")), "\r\n"));
+static_assert(eq(neo::find_newline_fn{}(std::string_view("\nab")), "\n"));
+static_assert(neo::find_newline_fn{}(std::string_view("ab\r")).empty());
+static_assert(neo::line_offsets(std::string_view("a\r\nbc\n")).size() == 3);
+
+TEST_CASE("Find line offsets") {
+    using offsets = std::vector<std::size_t>;
+    CHECK(neo::line_offsets(std::string_view("")) == offsets{});
+    CHECK(neo::line_offsets(std::string_view("foo")) == offsets{0});
+    CHECK(neo::line_offsets(std::string_view("foo\n")) == offsets{0, 4});
+    CHECK(neo::line_offsets(std::string_view("foo\r\nbar\n\nbaz")) == offsets{0, 5, 9, 10});
+
+    std::string     s = "one\r\ntwo\n\nthree\rfour\n";
+    std::list<char> l(s.begin(), s.end());
+    CHECK(neo::line_offsets(l) == neo::line_offsets(s));
+
+    // The offsets agree with iter_lines()
+    auto lines = neo::to_vector(neo::iter_lines(s));
+    auto offs  = neo::line_offsets(s);
+    REQUIRE(lines.size() == offs.size());
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        CHECK(static_cast<std::size_t>(lines[i].data() - s.data()) == offs[i]);
+    }
+}
+
+TEST_CASE("Line splitting throughput", "[.][benchmark]") {
+    std::string text;
+    for (int i = 0; text.size() < 64 * 1024 * 1024; ++i) {
+        text += "2024-01-01T00:00:00Z INFO request " + std::to_string(i) + " served in 12ms";
+        text += (i % 4 == 0) ? "\r\n" : "\n";
+    }
+
+    auto time_mb_per_s = [&](auto count) {
+        auto start = std::chrono::steady_clock::now();
+        auto n     = count();
+        auto dur   = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        return std::pair{n, double(text.size()) / 1e6 / dur.count()};
+    };
+    auto [n_iter, iter_speed] = time_mb_per_s([&] {
+        std::size_t n = 0;
+        for (auto&& line : neo::iter_lines(std::string_view(text))) {
+            n += line.empty() ? 0 : 1;
+        }
+        return n;
+    });
+    auto [n_offs, offs_speed] = time_mb_per_s([&] { return neo::line_offsets(text).size(); });
+    CHECK(n_offs == n_iter + 1);
+    std::printf("iter_lines: %7.1f MB/s, line_offsets: %7.1f MB/s\n", iter_speed, offs_speed);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "./attrib.hpp"
+#include "./platform.hpp"
+
+#include <string_view>
+
+namespace neo {
+
+/**
+ * @brief Get the name of a type, as spelled by the compiler.
+ *
+ * The name is extracted from the signature of a function template, so its spelling depends on
+ * the compiler. On compilers other than GCC and Clang, the whole signature is returned.
+ */
+template <typename T>
+constexpr std::string_view type_name() noexcept {
+    std::string_view sig = NEO_PRETTY_FUNC;
+#if NEO_COMPILER(GNU, Clang)
+    auto start = sig.find("T = ");
+    if (start == sig.npos) {
+        return sig;
+    }
+    sig.remove_prefix(start + 4);
+    return sig.substr(0, sig.find_first_of(";]"));
+#else
+    return sig;
+#endif
+}
+
+}  // namespace neo
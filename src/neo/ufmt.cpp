@@ -46,8 +46,12 @@ void write_str(std::string& out, std::basic_string_view<C> sv) noexcept {
     }
 }
 
+// Large enough for any integer, or for the shortest round-trip representation of any
+// floating-point value
+constexpr std::size_t max_val_chars = 64;
+
 void write_val(std::string& out, auto val) noexcept {
-    char buf[32];
+    char buf[max_val_chars];
     auto res     = std::to_chars(buf, buf + sizeof(buf), val);
     auto n_chars = res.ptr - buf;
     out.append(buf, buf + n_chars);
@@ -68,7 +72,9 @@ void neo::ufmt_detail::write_str(std::string& out, std::u32string_view sv) noexc
     ::write_str(out, sv);
 }
 
-void neo::ufmt_append(std::string& str, double d) noexcept { str.append(std::to_string(d)); }
+void neo::ufmt_append(std::string& str, float f) noexcept { ::write_val(str, f); }
+void neo::ufmt_append(std::string& str, double d) noexcept { ::write_val(str, d); }
+void neo::ufmt_append(std::string& str, long double d) noexcept { ::write_val(str, d); }
 
 void neo::ufmt_detail::write_i64(std::string& out, std::int64_t v) noexcept { ::write_val(out, v); }
 void neo::ufmt_detail::write_u64(std::string& out, std::uint64_t v) noexcept {
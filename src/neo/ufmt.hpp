@@ -1,13 +1,16 @@
 #pragma once
 
+#include <array>
 #include <concepts>
 #include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tuple>
 
 #include "./concepts.hpp"
+#include "./fixed_string.hpp"
 
 namespace neo {
 
@@ -68,7 +71,13 @@ void ufmt_append(std::string& str, I i) noexcept {
     }
 }
 
-void ufmt_append(std::string& str, double s) noexcept;
+/**
+ * @brief Append the shortest decimal representation of the given floating-point number that
+ * round-trips to the same value.
+ */
+void ufmt_append(std::string& str, float f) noexcept;
+void ufmt_append(std::string& str, double d) noexcept;
+void ufmt_append(std::string& str, long double d) noexcept;
 
 /// Check if the given T can be formatted via ufmt_append()
 template <typename T>
@@ -143,6 +152,121 @@ std::string ufmt(const std::string_view fmt_str, const Ts&... args) {
     return ret;
 }
 
+namespace ufmt_detail {
+
+/// Count the number of "{}" placeholders in the given format string
+constexpr std::size_t count_placeholders(std::string_view fmt) noexcept {
+    std::size_t n = 0;
+    for (auto pos = fmt.find("{}"); pos != fmt.npos; pos = fmt.find("{}", pos + 2)) {
+        ++n;
+    }
+    return n;
+}
+
+/// A literal part of a format string, between placeholders
+struct format_segment {
+    std::size_t offset;
+    std::size_t length;
+};
+
+/// The result of parsing a format string at compile-time
+template <basic_fixed_string Fmt>
+struct parsed_format {
+    static constexpr std::string_view string = Fmt;
+
+    /// The number of placeholders in the format string
+    static constexpr std::size_t n_placeholders = count_placeholders(string);
+
+    /// The literal parts of the format string. There is one more segment than placeholders.
+    static constexpr auto segments = [] {
+        std::array<format_segment, n_placeholders + 1> ret{};
+        std::size_t                                    start = 0;
+        for (std::size_t i = 0; i < n_placeholders; ++i) {
+            auto pos = string.find("{}", start);
+            ret[i]   = {start, pos - start};
+            start    = pos + 2;
+        }
+        ret[n_placeholders] = {start, string.size() - start};
+        return ret;
+    }();
+
+    /// The number of characters that will be copied from the format string
+    static constexpr std::size_t literal_size = string.size() - (n_placeholders * 2);
+
+    template <std::size_t I>
+    static constexpr std::string_view segment = string.substr(segments[I].offset,
+                                                              segments[I].length);
+};
+
+/// The number of decimal characters required to render any value of the integral type I
+template <std::integral I>
+constexpr std::size_t max_integral_chars
+    = static_cast<std::size_t>(std::numeric_limits<I>::digits10) + 1 + std::is_signed_v<I>;
+
+/**
+ * @brief Estimate the number of characters that will be required to render the given value.
+ *
+ * For numbers and booleans this is an upper bound derived from the type. For strings
+ * this is exact. For other types this returns zero, and the string will grow as needed.
+ */
+template <typename T>
+constexpr std::size_t size_hint(const T& item) noexcept {
+    if constexpr (std::same_as<T, bool>) {
+        return 5;
+    } else if constexpr (std::same_as<T, char>) {
+        return 1;
+    } else if constexpr (std::integral<T>) {
+        return max_integral_chars<T>;
+    } else if constexpr (std::floating_point<T>) {
+        // Enough for the shortest round-trip representation of the type
+        return std::numeric_limits<T>::max_digits10 + 8;
+    } else if constexpr (std::same_as<T, std::string> || std::same_as<T, std::string_view>) {
+        return item.size();
+    } else if constexpr (std::same_as<T, const char*> || std::same_as<T, char*>) {
+        return std::char_traits<char>::length(item);
+    } else {
+        return 0;
+    }
+}
+
+template <basic_fixed_string Fmt, std::size_t... Is, typename... Ts>
+constexpr void ufmt_into_fixed(std::string& out, std::index_sequence<Is...>, const Ts&... args) {
+    using parsed = parsed_format<Fmt>;
+    out.reserve(out.size() + parsed::literal_size + (size_hint(args) + ... + 0));
+    ((out.append(parsed::template segment<Is>), to_string_into(out, args)), ...);
+    out.append(parsed::template segment<sizeof...(Ts)>);
+}
+
+}  // namespace ufmt_detail
+
+/**
+ * @brief Append the result of the format-string `Fmt` with `args` to the end of `str`.
+ *
+ * The format string is parsed at compile-time, and a mismatch between the number of
+ * placeholders and the number of arguments is a compile-time error. The string is
+ * grown once, using an estimate of the output size based on the argument types.
+ */
+template <basic_fixed_string Fmt, formattable... Args>
+constexpr void ufmt_into(std::string& str, const Args&... args) {
+    static_assert(ufmt_detail::parsed_format<Fmt>::n_placeholders == sizeof...(Args),
+                  "The number of arguments given to neo::ufmt() does not match the number of "
+                  "placeholders in the format string");
+    ufmt_detail::ufmt_into_fixed<Fmt>(str, std::index_sequence_for<Args...>{}, args...);
+}
+
+/**
+ * @brief Generate a std::string containing the result of rendering the compile-time
+ * format-string `Fmt`.
+ *
+ * Usage: `neo::ufmt<"{} + {} = {}">(1, 2, 3)`
+ */
+template <basic_fixed_string Fmt, formattable... Ts>
+std::string ufmt(const Ts&... args) {
+    std::string ret;
+    ufmt_into<Fmt>(ret, args...);
+    return ret;
+}
+
 namespace _to_string_fn_ns_ {
 
 inline constexpr struct to_string_fn {
@@ -2,6 +2,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
 TEST_CASE("Format a simple string") {
     CHECK(neo::ufmt("Just a string") == "Just a string");
     CHECK(neo::ufmt("Number is {}", 34) == "Number is 34");
@@ -34,3 +39,89 @@ TEST_CASE("Custom format my_item") {
 
     CHECK(neo::to_string(item) == "52");
 }
+
+TEST_CASE("Format with a compile-time format string") {
+    CHECK(neo::ufmt<"Just a string">() == "Just a string");
+    CHECK(neo::ufmt<"Number is {}">(34) == "Number is 34");
+    CHECK(neo::ufmt<"{} + {} = {}">(1, 2, 3) == "1 + 2 = 3");
+    CHECK(neo::ufmt<"{}{}">(std::string_view("con"), std::string("cat")) == "concat");
+    CHECK(neo::ufmt<"{}, {}, {}">(true, 'c', -9'223'372'036'854'775'807LL - 1)
+          == "true, c, -9223372036854775808");
+    CHECK(neo::ufmt<"C string: {}">("hello") == "C string: hello");
+
+    my_item item;
+    item.i = 52;
+    CHECK(neo::ufmt<"item: {}!">(item) == "item: 52!");
+
+    std::string s = "Prefix: ";
+    neo::ufmt_into<"{} and {}">(s, 1, 2);
+    CHECK(s == "Prefix: 1 and 2");
+
+    using parsed = neo::ufmt_detail::parsed_format<"a{}bc{}{}d">;
+    static_assert(parsed::n_placeholders == 3);
+    static_assert(parsed::literal_size == 4);
+    static_assert(parsed::segment<0> == "a");
+    static_assert(parsed::segment<1> == "bc");
+    static_assert(parsed::segment<2> == "");
+    static_assert(parsed::segment<3> == "d");
+}
+
+TEST_CASE("Compile-time format reserves the output once") {
+    std::string s = neo::ufmt<"{} {} {} {}">(std::uint64_t(-1), std::int64_t(-1), 3.5, "str");
+    CHECK(s.starts_with("18446744073709551615 -1 3.5"));
+    CHECK(s.ends_with(" str"));
+    CHECK(neo::ufmt_detail::size_hint(std::uint64_t(-1)) == 20);
+    CHECK(neo::ufmt_detail::size_hint(std::int64_t(-1)) == 20);
+    CHECK(neo::ufmt_detail::size_hint(std::int8_t(-1)) == 4);
+
+    // Numbers are appended within the reserved size, without growing the string again
+    std::string out(40, 'x');
+    std::string reserved = out;
+    reserved.reserve(40 + neo::ufmt_detail::size_hint(std::int64_t(-1)));
+    neo::ufmt_into<"{}">(out, std::int64_t(-1));
+    CHECK(out.size() == 42);
+    CHECK(out.capacity() == reserved.capacity());
+}
+
+TEST_CASE("Format floating-point numbers") {
+    CHECK(neo::ufmt("{}", 0.1) == "0.1");
+    CHECK(neo::ufmt("{}", 41.2) == "41.2");
+    CHECK(neo::ufmt("{}", 41.2f) == "41.2");
+    CHECK(neo::ufmt("{}", -0.0) == "-0");
+    CHECK(neo::ufmt("{}", 1e300) == "1e+300");
+    CHECK(neo::ufmt("{}", 1.0 / 3) == "0.3333333333333333");
+    CHECK(neo::ufmt("{}", 1.0f / 3) == "0.33333334");
+    CHECK(neo::ufmt("{}", 2.5L) == "2.5");
+    CHECK(neo::ufmt("{}", std::numeric_limits<double>::infinity()) == "inf");
+    CHECK(neo::ufmt("{}", std::nan("")) == "nan");
+    CHECK(neo::ufmt<"{}">(5e-324) == "5e-324");
+
+    for (double d : {std::numeric_limits<double>::max(),
+                     std::numeric_limits<double>::min(),
+                     std::numeric_limits<double>::lowest(),
+                     std::numeric_limits<double>::denorm_min(),
+                     123456789.123456789,
+                     -2.2250738585072014e-308}) {
+        auto str = neo::ufmt("{}", d);
+        CHECK(std::strtod(str.c_str(), nullptr) == d);
+        CHECK(str.size() <= neo::ufmt_detail::size_hint(d));
+    }
+}
+
+TEST_CASE("Floating-point formatting throughput", "[.][benchmark]") {
+    constexpr int n_values = 1'000'000;
+    auto          time_it  = [&](const char* name, auto fn) {
+        std::string out;
+        auto        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n_values; ++i) {
+            out.clear();
+            fn(out, i * 1.37);
+        }
+        auto dur = std::chrono::steady_clock::now() - start;
+        std::printf("%-16s %6.2f ns per value\n",
+                    name,
+                    std::chrono::duration<double, std::nano>(dur).count() / n_values);
+    };
+    time_it("std::to_string", [](std::string& out, double d) { out.append(std::to_string(d)); });
+    time_it("ufmt_append", [](std::string& out, double d) { neo::ufmt_append(out, d); });
+}
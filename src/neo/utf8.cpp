@@ -1,5 +1,370 @@
 #include "./utf8.hpp"
 
+#include "./config-pp.hpp"
+#include "./platform.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+// clang-format off
+#if defined(__x86_64__) || defined(_M_X64)
+    #define NEO_UTF8_SSE2 Enabled
+    #include <emmintrin.h>
+    #if NEO_COMPILER(GNU, Clang)
+        // We compile the AVX2 kernel with a target attribute, and dispatch at runtime.
+        #define NEO_UTF8_AVX2 Enabled
+        #define NEO_UTF8_AVX2_TARGET [[gnu::target("avx2")]]
+        #include <immintrin.h>
+    #else
+        #define NEO_UTF8_AVX2 Disabled
+    #endif
+#else
+    #define NEO_UTF8_SSE2 Disabled
+    #define NEO_UTF8_AVX2 Disabled
+#endif
+// clang-format on
+
 using namespace neo;
 
 template utf8_codepoint neo::next_utf8_codepoint(const std::byte*, const std::byte*) noexcept;
+
+namespace {
+
+using u8 = std::uint8_t;
+
+/// Decode a single codepoint, additionally rejecting encoded surrogates
+utf8_codepoint decode_one(const std::byte* it, const std::byte* stop) noexcept {
+    auto cp = neo::next_utf8_codepoint(it, stop);
+    if (!cp.error() && cp.codepoint >= 0xd800 && cp.codepoint <= 0xdfff) {
+        return utf8_codepoint::make_error(utf8_errc::invalid_codepoint, cp.size);
+    }
+    return cp;
+}
+
+/// Return a pointer to the first non-ASCII byte in the given range, or `stop`
+const std::byte* skip_ascii(const std::byte* it, const std::byte* stop) noexcept {
+#if NEO_IsEnabled(NEO_UTF8_SSE2)
+    while (stop - it >= 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto mask  = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+        if (mask != 0) {
+            return it + std::countr_zero(mask);
+        }
+        it += 16;
+    }
+#endif
+    if constexpr (std::endian::native == std::endian::little) {
+        constexpr std::uint64_t high_bits = 0x8080'8080'8080'8080;
+        while (stop - it >= 8) {
+            std::uint64_t word;
+            std::memcpy(&word, it, sizeof word);
+            if (word & high_bits) {
+                return it + std::countr_zero(word & high_bits) / 8;
+            }
+            it += 8;
+        }
+    }
+    while (it != stop && static_cast<u8>(*it) < 0x80) {
+        ++it;
+    }
+    return it;
+}
+
+/// Validate starting at the given position, one codepoint at a time (with an ASCII fast path)
+utf8_bulk_result
+validate_scalar(const std::byte* begin, const std::byte* it, const std::byte* stop) noexcept {
+    while (it != stop) {
+        it = skip_ascii(it, stop);
+        if (it == stop) {
+            break;
+        }
+        auto cp = decode_one(it, stop);
+        if (cp.error() != utf8_errc::none) {
+            return {cp.error(), static_cast<std::size_t>(it - begin)};
+        }
+        it += cp.size;
+    }
+    return {utf8_errc::none, static_cast<std::size_t>(stop - begin)};
+}
+
+/// Back up the given pointer to the beginning of the codepoint that contains it
+const std::byte* rewind_to_lead(const std::byte* begin, const std::byte* it) noexcept {
+    int n = 0;
+    while (it != begin && n < 3 && (static_cast<u8>(*it) & 0b1100'0000) == 0b1000'0000) {
+        --it;
+        ++n;
+    }
+    return it;
+}
+
+#if NEO_IsEnabled(NEO_UTF8_AVX2)
+
+/**
+ * Vectorized validation using the lookup-table scheme of Keiser and Lemire ("Validating UTF-8
+ * In Less Than One Instruction Per Byte"), as used in simdjson. Each byte is classified by
+ * its high nibble, the high nibble of its predecessor and the low nibble of its predecessor.
+ * The three table lookups are AND-ed, and any remaining bit indicates an error.
+ */
+namespace avx2 {
+
+constexpr u8 too_short      = 1 << 0;
+constexpr u8 too_long       = 1 << 1;
+constexpr u8 overlong_3     = 1 << 2;
+constexpr u8 too_large      = 1 << 3;
+constexpr u8 surrogate      = 1 << 4;
+constexpr u8 overlong_2     = 1 << 5;
+constexpr u8 too_large_1000 = 1 << 6;
+constexpr u8 overlong_4     = 1 << 6;
+constexpr u8 two_conts      = 1 << 7;
+constexpr u8 carry          = too_short | too_long | two_conts;
+
+constexpr u8 byte_1_high_table[16] = {
+    // 0_______ ________ <ASCII in byte 1>
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    too_long,
+    // 10______ ________ <continuation in byte 1>
+    two_conts,
+    two_conts,
+    two_conts,
+    two_conts,
+    // 1100____ ________ <two byte lead in byte 1>
+    too_short | overlong_2,
+    // 1101____ ________ <two byte lead in byte 1>
+    too_short,
+    // 1110____ ________ <three byte lead in byte 1>
+    too_short | overlong_3 | surrogate,
+    // 1111____ ________ <four+ byte lead in byte 1>
+    too_short | too_large | too_large_1000 | overlong_4,
+};
+
+constexpr u8 byte_1_low_table[16] = {
+    // ____0000 ________
+    carry | overlong_3 | overlong_2 | overlong_4,
+    // ____0001 ________
+    carry | overlong_2,
+    // ____001_ ________
+    carry,
+    carry,
+    // ____0100 ________
+    carry | too_large,
+    // ____0101 ________
+    carry | too_large | too_large_1000,
+    // ____011_ ________
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    // ____1___ ________
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    // ____1101 ________
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+};
+
+constexpr u8 byte_2_high_table[16] = {
+    // ________ 0_______ <ASCII in byte 2>
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+    // ________ 1000____
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+    // ________ 1001____
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    // ________ 101_____
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    // ________ 11______ <lead byte in byte 2>
+    too_short,
+    too_short,
+    too_short,
+    too_short,
+};
+
+NEO_UTF8_AVX2_TARGET inline __m256i broadcast_table(const u8 (&t)[16]) noexcept {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+}
+
+NEO_UTF8_AVX2_TARGET inline __m256i high_nibbles(__m256i v) noexcept {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+}
+
+/// Shift the bytes of `input` "right" by N, filling from the tail of `prev`
+template <int N>
+NEO_UTF8_AVX2_TARGET inline __m256i prev_bytes(__m256i input, __m256i prev) noexcept {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+struct checker {
+    __m256i byte_1_high;
+    __m256i byte_1_low;
+    __m256i byte_2_high;
+    __m256i incomplete_max;
+
+    __m256i error           = _mm256_setzero_si256();
+    __m256i prev_input      = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+
+    NEO_UTF8_AVX2_TARGET checker() noexcept
+        : byte_1_high(broadcast_table(byte_1_high_table))
+        , byte_1_low(broadcast_table(byte_1_low_table))
+        , byte_2_high(broadcast_table(byte_2_high_table))
+        // The last three bytes of a block may not begin a codepoint that needs more bytes
+        , incomplete_max(_mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          -1, -1, -1, -1, -1, -1, -1,
+                                          static_cast<char>(0xf0 - 1),
+                                          static_cast<char>(0xe0 - 1),
+                                          static_cast<char>(0xc0 - 1))) {}
+
+    NEO_UTF8_AVX2_TARGET void check_block(__m256i input) noexcept {
+        if (_mm256_movemask_epi8(input) == 0) {
+            // All ASCII. Only an incomplete codepoint from the prior block can be an error.
+            error = _mm256_or_si256(error, prev_incomplete);
+            return;
+        }
+        const auto prev1 = prev_bytes<1>(input, prev_input);
+        const auto special
+            = _mm256_and_si256(_mm256_and_si256(_mm256_shuffle_epi8(byte_1_high,
+                                                                    high_nibbles(prev1)),
+                                                _mm256_shuffle_epi8(byte_1_low,
+                                                                    _mm256_and_si256(
+                                                                        prev1,
+                                                                        _mm256_set1_epi8(0x0f)))),
+                               _mm256_shuffle_epi8(byte_2_high, high_nibbles(input)));
+        // Bytes that must be the third or fourth byte of a multi-byte codepoint
+        const auto prev2      = prev_bytes<2>(input, prev_input);
+        const auto prev3      = prev_bytes<3>(input, prev_input);
+        const auto is_third   = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80));
+        const auto is_fourth  = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80));
+        const auto must23_80  = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth),
+                                                _mm256_set1_epi8(static_cast<char>(0x80)));
+        const auto length_err = _mm256_xor_si256(must23_80, special);
+        error                 = _mm256_or_si256(error, length_err);
+        prev_incomplete       = _mm256_subs_epu8(input, incomplete_max);
+        prev_input            = input;
+    }
+
+    NEO_UTF8_AVX2_TARGET bool has_error() const noexcept {
+        return not _mm256_testz_si256(error, error);
+    }
+};
+
+NEO_UTF8_AVX2_TARGET utf8_bulk_result validate(const std::byte* begin,
+                                               const std::byte* stop) noexcept {
+    checker          chk;
+    const std::byte* it         = begin;
+    const std::byte* prev_block = begin;
+    while (stop - it >= 32) {
+        chk.check_block(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)));
+        if (chk.has_error()) {
+            // The error is within this block or at the tail of the previous one.
+            return validate_scalar(begin, rewind_to_lead(begin, prev_block), stop);
+        }
+        prev_block = it;
+        it += 32;
+    }
+    // Check the tail, padded with ASCII nulls
+    alignas(32) std::byte tail[32] = {};
+    std::memcpy(tail, it, static_cast<std::size_t>(stop - it));
+    chk.check_block(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    chk.error = _mm256_or_si256(chk.error, chk.prev_incomplete);
+    if (chk.has_error()) {
+        return validate_scalar(begin, rewind_to_lead(begin, prev_block), stop);
+    }
+    return {utf8_errc::none, static_cast<std::size_t>(stop - begin)};
+}
+
+}  // namespace avx2
+
+bool have_avx2() noexcept {
+    static const bool have = __builtin_cpu_supports("avx2");
+    return have;
+}
+
+#endif  // NEO_UTF8_AVX2
+
+}  // namespace
+
+utf8_bulk_result neo::utf8_validate(std::span<const std::byte> bytes) noexcept {
+    const auto begin = bytes.data();
+    const auto stop  = begin + bytes.size();
+#if NEO_IsEnabled(NEO_UTF8_AVX2)
+    if (have_avx2()) {
+        return avx2::validate(begin, stop);
+    }
+#endif
+    return validate_scalar(begin, begin, stop);
+}
+
+utf8_bulk_result neo::utf8_validate(std::string_view str) noexcept {
+    return neo::utf8_validate(std::as_bytes(std::span(str)));
+}
+
+utf8_bulk_result neo::utf8_decode_into(std::span<const std::byte> bytes,
+                                       std::span<char32_t>        out) noexcept {
+    const auto begin    = bytes.data();
+    const auto stop     = begin + bytes.size();
+    auto       it       = begin;
+    auto       out_it   = out.data();
+    const auto out_stop = out_it + out.size();
+
+    auto make_result = [&](utf8_errc ec) -> utf8_bulk_result {
+        return {ec,
+                static_cast<std::size_t>(it - begin),
+                static_cast<std::size_t>(out_it - out.data())};
+    };
+
+    while (it != stop && out_it != out_stop) {
+#if NEO_IsEnabled(NEO_UTF8_SSE2)
+        // Widen blocks of ASCII directly to UTF-32
+        const auto zero = _mm_setzero_si128();
+        while (stop - it >= 16 && out_stop - out_it >= 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            if (_mm_movemask_epi8(chunk) != 0) {
+                break;
+            }
+            const auto lo = _mm_unpacklo_epi8(chunk, zero);
+            const auto hi = _mm_unpackhi_epi8(chunk, zero);
+            auto       o  = reinterpret_cast<__m128i*>(out_it);
+            _mm_storeu_si128(o + 0, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(o + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(o + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(o + 3, _mm_unpackhi_epi16(hi, zero));
+            it += 16;
+            out_it += 16;
+        }
+#endif
+        while (it != stop && out_it != out_stop && static_cast<u8>(*it) < 0x80) {
+            *out_it++ = static_cast<char32_t>(*it++);
+        }
+        if (it == stop || out_it == out_stop) {
+            break;
+        }
+        auto cp = decode_one(it, stop);
+        if (cp.error() != utf8_errc::none) {
+            return make_result(cp.error());
+        }
+        *out_it++ = cp.codepoint;
+        it += cp.size;
+    }
+    return make_result(utf8_errc::none);
+}
+
+utf8_bulk_result neo::utf8_decode_into(std::string_view str, std::span<char32_t> out) noexcept {
+    return neo::utf8_decode_into(std::as_bytes(std::span(str)), out);
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <span>
+#include <string_view>
 
 #include "./assert.hpp"
 #include "./enum.hpp"
@@ -172,6 +174,49 @@ constexpr utf8_codepoint next_utf8_codepoint(std::ranges::input_range auto&& rng
     return neo::next_utf8_codepoint(std::ranges::begin(rng), std::ranges::end(rng));
 }
 
+/**
+ * @brief The result of a bulk UTF-8 validation or decoding operation
+ */
+struct utf8_bulk_result {
+    /// The error that stopped the operation, if any
+    utf8_errc error = utf8_errc::none;
+    /// The number of input bytes that were fully consumed. If an error occurred, this is the
+    /// offset of the beginning of the invalid codepoint.
+    std::size_t n_bytes = 0;
+    /// The number of codepoints that were written to the output (only set for decoding)
+    std::size_t n_codepoints = 0;
+};
+
+/**
+ * @brief Check that the given bytes are well-formed UTF-8.
+ *
+ * Unlike `next_utf8_codepoint`, this also rejects encoded surrogate codepoints (U+D800
+ * through U+DFFF) as `utf8_errc::invalid_codepoint`.
+ *
+ * Where available, this uses a vectorized implementation that checks the input in blocks,
+ * and only falls back to scalar decoding to locate an error.
+ *
+ * @return utf8_bulk_result If valid, `n_bytes` is the size of the input. Otherwise `n_bytes` is
+ * the offset of the first invalid codepoint.
+ */
+utf8_bulk_result utf8_validate(std::span<const std::byte> bytes) noexcept;
+utf8_bulk_result utf8_validate(std::string_view str) noexcept;
+
+/**
+ * @brief Decode UTF-8 bytes into UTF-32 codepoints.
+ *
+ * Decoding stops at the first invalid codepoint, when the input is exhausted, or when
+ * the output span is full. The input is validated in the same manner as `utf8_validate`.
+ *
+ * @param bytes The UTF-8 input
+ * @param out The destination for decoded codepoints
+ * @return utf8_bulk_result The number of bytes consumed and codepoints written. Decoding may
+ * be resumed by advancing the input by `n_bytes`.
+ */
+utf8_bulk_result utf8_decode_into(std::span<const std::byte> bytes,
+                                  std::span<char32_t>        out) noexcept;
+utf8_bulk_result utf8_decode_into(std::string_view str, std::span<char32_t> out) noexcept;
+
 /**
  * @brief Adapt a range of UTF8 code units into a range of UTF-32 codepoints
  *
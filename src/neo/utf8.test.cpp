@@ -76,3 +76,99 @@ static_assert(
     std::same_as<neo::utf8_codepoint,
                  decltype(neo::next_utf8_codepoint(std::declval<std::istream_iterator<char>>(),
                                                    std::declval<std::istream_iterator<char>>()))>);
+
+namespace {
+
+// Reference validation: decode one codepoint at a time
+neo::utf8_bulk_result reference_validate(std::string_view str) {
+    auto it = str.begin();
+    while (it != str.end()) {
+        auto cp = neo::next_utf8_codepoint(it, str.end());
+        if (!cp.error() && cp.codepoint >= 0xd800 && cp.codepoint <= 0xdfff) {
+            cp = neo::utf8_codepoint::make_error(neo::utf8_errc::invalid_codepoint);
+        }
+        if (cp.error() != neo::utf8_errc::none) {
+            return {cp.error(), static_cast<std::size_t>(it - str.begin())};
+        }
+        it += static_cast<std::ptrdiff_t>(cp.size);
+    }
+    return {neo::utf8_errc::none, str.size()};
+}
+
+}  // namespace
+
+TEST_CASE("Validate UTF-8 in bulk") {
+    CHECK(neo::utf8_validate("").error == neo::utf8_errc::none);
+    CHECK(neo::utf8_validate("Hello, world!").n_bytes == 13);
+    CHECK(neo::utf8_validate("I am 😉 and Ünïcödé").error == neo::utf8_errc::none);
+
+    // Encoded surrogate
+    auto res = neo::utf8_validate("abc\xed\xa0\x80");
+    CHECK(res.error == neo::utf8_errc::invalid_codepoint);
+    CHECK(res.n_bytes == 3);
+
+    // Truncated codepoint at the end
+    res = neo::utf8_validate("abc\xf0\x9f\x98");
+    CHECK(res.error == neo::utf8_errc::need_more);
+    CHECK(res.n_bytes == 3);
+
+    // Stray continuation byte
+    res = neo::utf8_validate("a\x80");
+    CHECK(res.error == neo::utf8_errc::invalid_start_byte);
+    CHECK(res.n_bytes == 1);
+}
+
+TEST_CASE("Bulk validation agrees with the codepoint decoder") {
+    // Build a long mixed string, then corrupt or truncate it at each position. This exercises
+    // errors at every position relative to the vectorized block boundaries.
+    std::string base;
+    for (int i = 0; i < 12; ++i) {
+        base += "ascii text ";
+        base += "é";
+        base += "€uro";
+        base += "😉";
+    }
+    REQUIRE(neo::utf8_validate(base).error == neo::utf8_errc::none);
+    const char bad_bytes[] = {'\x80', '\xbf', '\xc0', '\xc1', '\xe0', '\xed', '\xf4', '\xf5', '\xff'};
+    for (std::size_t pos = 0; pos < base.size(); ++pos) {
+        for (char bad : bad_bytes) {
+            auto str  = base;
+            str[pos]  = bad;
+            auto want = reference_validate(str);
+            auto got  = neo::utf8_validate(str);
+            if (got.error != want.error || got.n_bytes != want.n_bytes) {
+                INFO("Position " << pos << ", byte " << int(static_cast<unsigned char>(bad)));
+                CHECK(got.error == want.error);
+                CHECK(got.n_bytes == want.n_bytes);
+            }
+        }
+        auto truncated = std::string_view(base).substr(0, pos);
+        auto want      = reference_validate(truncated);
+        auto got       = neo::utf8_validate(truncated);
+        CHECK(got.error == want.error);
+        CHECK(got.n_bytes == want.n_bytes);
+    }
+}
+
+TEST_CASE("Decode UTF-8 in bulk") {
+    std::u32string out(64, U'\0');
+    auto           res = neo::utf8_decode_into("I am 😉 and a long string of ASCII text", out);
+    CHECK(res.error == neo::utf8_errc::none);
+    out.resize(res.n_codepoints);
+    CHECK(out == U"I am 😉 and a long string of ASCII text");
+
+    // Stop when the output is full, at a codepoint boundary
+    char32_t small[3];
+    res = neo::utf8_decode_into("ab😉cd", small);
+    CHECK(res.error == neo::utf8_errc::none);
+    CHECK(res.n_codepoints == 3);
+    CHECK(res.n_bytes == 6);
+    CHECK(small[2] == U'😉');
+
+    // Stop at an error
+    res = neo::utf8_decode_into("abcdefghijklmnopqrstuvwxyz\xc0\xaf", out);
+    CHECK(res.error == neo::utf8_errc::overlong_encoded);
+    CHECK(res.n_bytes == 26);
+    CHECK(res.n_codepoints == 26);
+    CHECK(out[25] == U'z');
+}
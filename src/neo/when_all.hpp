@@ -0,0 +1,133 @@
+#pragma once
+
+#include "./await.hpp"
+#include "./await_driver.hpp"
+#include "./fwd.hpp"
+#include "./type_traits.hpp"
+#include "./unit.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace neo {
+
+namespace when_all_detail {
+
+/// Shared completion state for all children of a when_all
+struct counter {
+    std::atomic<std::size_t> count{0};
+    std::coroutine_handle<>  continuation;
+
+    /// Mark one participant as complete. Returns `true` for the final participant.
+    bool arrive() noexcept { return count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+/// Counts a child as complete, and resumes the awaiter after the final child
+struct arrive {
+    counter* _counter = nullptr;
+
+    std::coroutine_handle<> operator()() const noexcept {
+        if (_counter->arrive()) {
+            return _counter->continuation;
+        }
+        return std::noop_coroutine();
+    }
+};
+
+/// The coroutine type that awaits each child awaitable
+template <typename T>
+using task = await_driver_detail::driver<T, arrive>;
+
+template <typename T, typename Awaitable>
+task<T> make_task(Awaitable&& a) {
+    return await_driver_detail::make_driver<T, arrive>(NEO_FWD(a));
+}
+
+/// Take the result of a child, with `void` results as `neo::unit`
+template <typename T>
+nonvoid_t<T> take(task<T>& t) {
+    if constexpr (void_type<T>) {
+        t.take();
+        return unit{};
+    } else {
+        return t.take();
+    }
+}
+
+}  // namespace when_all_detail
+
+/**
+ * @brief An awaitable that concurrently awaits several other awaitables.
+ *
+ * Created by `when_all()`. Awaiting this object will start awaiting each of the
+ * given awaitables in sequence on the current thread, and suspends until all of
+ * them have completed (possibly on other threads).
+ *
+ * The result of the `co_await` is a `std::tuple` of the results of each awaitable,
+ * in order. `void` results are represented by `neo::unit`.
+ */
+template <typename... As>
+class [[nodiscard]] when_all_awaitable {
+    std::tuple<As...> _awaitables;
+
+    template <std::size_t... Is>
+    class awaiter {
+        when_all_detail::counter _counter;
+        std::tuple<when_all_detail::task<await_result_t<As>>...> _tasks;
+
+    public:
+        explicit awaiter(std::tuple<As...>& aws)
+            : _tasks(when_all_detail::make_task<await_result_t<As>>(
+                static_cast<As&&>(std::get<Is>(aws)))...) {}
+
+        bool await_ready() const noexcept { return sizeof...(As) == 0; }
+
+        bool await_suspend(std::coroutine_handle<> co) noexcept {
+            _counter.continuation = co;
+            // One extra count for ourselves, so that children cannot resume us before we have
+            // finished starting all of them.
+            _counter.count.store(sizeof...(As) + 1, std::memory_order_relaxed);
+            ((std::get<Is>(_tasks).completion()._counter = &_counter), ...);
+            (std::get<Is>(_tasks).start(), ...);
+            // If we are the final participant, do not suspend
+            return not _counter.arrive();
+        }
+
+        std::tuple<nonvoid_t<await_result_t<As>>...> await_resume() {
+            (std::get<Is>(_tasks).rethrow_if_failed(), ...);
+            return std::tuple<nonvoid_t<await_result_t<As>>...>(
+                when_all_detail::take(std::get<Is>(_tasks))...);
+        }
+    };
+
+    template <std::size_t... Is>
+    auto _make_awaiter(std::index_sequence<Is...>) {
+        return awaiter<Is...>{_awaitables};
+    }
+
+public:
+    explicit when_all_awaitable(As&&... as)
+        : _awaitables(NEO_FWD(as)...) {}
+
+    auto operator co_await() && { return _make_awaiter(std::index_sequence_for<As...>{}); }
+};
+
+/**
+ * @brief Create an awaitable that awaits all of the given awaitables concurrently.
+ *
+ * Lvalue awaitables are held by reference, and rvalue awaitables are moved into the
+ * returned object.
+ *
+ * @return when_all_awaitable An awaitable that completes when all awaitables have completed.
+ * If any awaitable throws, the first exception (in argument order) is rethrown after all
+ * awaitables have finished.
+ */
+template <awaitable... As>
+when_all_awaitable<As...> when_all(As&&... as) {
+    return when_all_awaitable<As...>(NEO_FWD(as)...);
+}
+
+}  // namespace neo
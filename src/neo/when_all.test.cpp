@@ -0,0 +1,50 @@
+#include "./when_all.hpp"
+
+#include "./immediate.hpp"
+#include "./sync_wait.hpp"
+#include "./task.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+neo::task<int> get_int(int n) { co_return n; }
+
+neo::task<std::string> get_string() { co_return "hello"; }
+
+neo::task<> do_nothing() { co_return; }
+
+neo::task<int> throws() {
+    throw std::runtime_error("nope");
+    co_return 0;
+}
+
+}  // namespace
+
+TEST_CASE("Await several tasks") {
+    auto [a, b, c, nil] = neo::sync_wait(neo::when_all(get_int(3), get_string(), get_int(4), do_nothing()));
+    CHECK(a == 3);
+    CHECK(b == "hello");
+    CHECK(c == 4);
+    static_assert(std::same_as<decltype(nil), neo::unit>);
+}
+
+TEST_CASE("Await nothing") {
+    auto t = neo::sync_wait(neo::when_all());
+    static_assert(std::same_as<decltype(t), std::tuple<>>);
+}
+
+TEST_CASE("Await lvalue awaitables") {
+    auto t1  = get_int(5);
+    auto imm = neo::immediate{7};
+    auto [a, b] = neo::sync_wait(neo::when_all(t1, imm));
+    CHECK(a == 5);
+    CHECK(b == 7);
+}
+
+TEST_CASE("when_all rethrows") {
+    CHECK_THROWS_AS(neo::sync_wait(neo::when_all(get_int(1), throws())), std::runtime_error);
+}